@@ -0,0 +1,205 @@
+#include <algorithm>
+#include <cstdint>
+#include <functional>
+#include <iostream>
+#include <random>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include "bench_common.hpp"
+#include "bigint.hpp"
+
+/**
+ * @brief The options of the benchmark, read from the command line.
+ */
+struct BenchOptions {
+    std::string format = "csv";
+    size_t maxDigits = 10000000;
+    double minTime = 0.2;
+    double budget = 2.0;
+    std::vector<std::string> operations;
+};
+
+/**
+ * @brief One measured operation at one operand size.
+ */
+struct BenchResult {
+    std::string operation;
+    size_t digits;
+    uint64_t iterations;
+    double nanosecondsPerCall;
+};
+
+/**
+ * @brief One benchmarked operation.
+ *
+ * prepare builds the operands for a size, outside of the timed region, and returns
+ * the call to time. maxDigits limits the sizes, for example int64_t construction.
+ */
+struct BenchOperation {
+    std::string name;
+    std::function<std::function<void()>(size_t)> prepare;
+    size_t maxDigits;
+};
+
+/**
+ * @brief Lists every benchmarked operation.
+ *
+ * The comparisons use the slowest operands, where every digit has to be scanned:
+ * compare_less compares values that only differ in the lowest digit, and
+ * compare_equal compares equal values.
+ *
+ * @param rng The random generator for the operands.
+ * @return The operations.
+ */
+std::vector<BenchOperation> benchOperations(std::mt19937_64& rng) {
+    std::vector<BenchOperation> operations;
+    operations.push_back({"construct_int64", [&rng](size_t digits) {
+        int64_t value = std::stoll(randomDigits(digits, rng));
+        return std::function<void()>([value] { benchSink = benchSink + (BigInt(value) == BigInt(0) ? 0 : 1); });
+    }, 18});
+    operations.push_back({"construct_string", [&rng](size_t digits) {
+        std::string str = randomDigits(digits, rng);
+        return std::function<void()>([str] { benchSink = benchSink + (BigInt(str) == BigInt(0) ? 0 : 1); });
+    }, SIZE_MAX});
+    operations.push_back({"add", [&rng](size_t digits) {
+        BigInt a(randomDigits(digits, rng));
+        BigInt b(randomDigits(digits, rng));
+        return std::function<void()>([a, b] { benchSink = benchSink + ((a + b) == a ? 0 : 1); });
+    }, SIZE_MAX});
+    operations.push_back({"subtract", [&rng](size_t digits) {
+        BigInt a(randomDigits(digits, rng));
+        BigInt b(randomDigits(digits, rng));
+        return std::function<void()>([a, b] { benchSink = benchSink + ((a - b) == a ? 0 : 1); });
+    }, SIZE_MAX});
+    operations.push_back({"multiply", [&rng](size_t digits) {
+        BigInt a(randomDigits(digits, rng));
+        BigInt b(randomDigits(digits, rng));
+        return std::function<void()>([a, b] { benchSink = benchSink + ((a * b) == a ? 0 : 1); });
+    }, SIZE_MAX});
+    operations.push_back({"compare_less", [&rng](size_t digits) {
+        BigInt a(randomDigits(digits, rng));
+        BigInt b = a + BigInt(1);
+        return std::function<void()>([a, b] { benchSink = benchSink + (a < b ? 1 : 0); });
+    }, SIZE_MAX});
+    operations.push_back({"compare_equal", [&rng](size_t digits) {
+        BigInt a(randomDigits(digits, rng));
+        BigInt b = a;
+        return std::function<void()>([a, b] { benchSink = benchSink + (a == b ? 1 : 0); });
+    }, SIZE_MAX});
+    operations.push_back({"print", [&rng](size_t digits) {
+        BigInt a(randomDigits(digits, rng));
+        return std::function<void()>([a] {
+            std::ostringstream output;
+            output << a;
+            benchSink = benchSink + output.str().size();
+        });
+    }, SIZE_MAX});
+    return operations;
+}
+
+/**
+ * @brief Reads the command line options.
+ *
+ * @param argc The number of arguments.
+ * @param argv The arguments.
+ * @param options Receives the options.
+ * @return Returns true if the options are valid, false otherwise.
+ */
+bool parseOptions(int argc, char* argv[], BenchOptions& options) {
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+        if (i + 1 >= argc) {
+            return false;
+        }
+        std::string value = argv[++i];
+        if (arg == "--format" && (value == "csv" || value == "json")) {
+            options.format = value;
+        } else if (arg == "--max-digits") {
+            options.maxDigits = std::stoull(value);
+        } else if (arg == "--min-time") {
+            options.minTime = std::stod(value);
+        } else if (arg == "--budget") {
+            options.budget = std::stod(value);
+        } else if (arg == "--ops") {
+            std::stringstream list(value);
+            std::string name;
+            while (std::getline(list, name, ',')) {
+                options.operations.push_back(name);
+            }
+        } else {
+            return false;
+        }
+    }
+    return true;
+}
+
+/**
+ * @brief Prints the results as CSV or JSON.
+ *
+ * @param results The results.
+ * @param format Either "csv" or "json".
+ */
+void printResults(const std::vector<BenchResult>& results, const std::string& format) {
+    if (format == "csv") {
+        std::cout << "operation,digits,iterations,ns_per_call,digits_per_second\n";
+        for (const BenchResult& result : results) {
+            std::cout << result.operation << ',' << result.digits << ',' << result.iterations << ','
+                      << result.nanosecondsPerCall << ','
+                      << static_cast<double>(result.digits) * 1e9 / result.nanosecondsPerCall << '\n';
+        }
+        return;
+    }
+    std::cout << "[\n";
+    for (size_t i = 0; i < results.size(); ++i) {
+        const BenchResult& result = results[i];
+        std::cout << "  {\"operation\": \"" << result.operation << "\", \"digits\": " << result.digits
+                  << ", \"iterations\": " << result.iterations << ", \"ns_per_call\": " << result.nanosecondsPerCall
+                  << ", \"digits_per_second\": " << static_cast<double>(result.digits) * 1e9 / result.nanosecondsPerCall
+                  << "}" << (i + 1 < results.size() ? "," : "") << "\n";
+    }
+    std::cout << "]\n";
+}
+
+/**
+ * @brief The main function of the benchmark.
+ *
+ * Times every operation at 1, 10, 100, ... digits up to --max-digits. An operation stops
+ * growing once its next call is predicted to take longer than --budget seconds, from the
+ * growth between its last two sizes, so the quadratic operations end early.
+ *
+ * @param argc The number of arguments.
+ * @param argv The arguments: --format csv|json, --max-digits N, --min-time S, --budget S, --ops a,b,c.
+ * @return Returns 0 on success, 1 for invalid options.
+ */
+int main(int argc, char* argv[]) {
+    BenchOptions options;
+    if (!parseOptions(argc, argv, options)) {
+        std::cerr << "Usage: bench [--format csv|json] [--max-digits N] [--min-time S] [--budget S] [--ops a,b,c]\n";
+        return 1;
+    }
+
+    std::mt19937_64 rng(701);
+    std::vector<BenchResult> results;
+    for (const BenchOperation& operation : benchOperations(rng)) {
+        if (!options.operations.empty() &&
+            std::find(options.operations.begin(), options.operations.end(), operation.name) == options.operations.end()) {
+            continue;
+        }
+        double previous = 0;
+        for (size_t digits = 1; digits <= std::min(options.maxDigits, operation.maxDigits); digits *= 10) {
+            std::function<void()> call = operation.prepare(digits);
+            uint64_t iterations = 0;
+            double nanoseconds = timeCall(call, options.minTime, iterations);
+            results.push_back({operation.name, digits, iterations, nanoseconds});
+            double growth = previous > 0 ? nanoseconds / previous : 10.0;
+            previous = nanoseconds;
+            if (nanoseconds * std::max(growth, 1.0) > options.budget * 1e9) {
+                break;
+            }
+        }
+    }
+    printResults(results, options.format);
+    return 0;
+}
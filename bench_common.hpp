@@ -0,0 +1,74 @@
+#ifndef BENCH_COMMON_HPP
+#define BENCH_COMMON_HPP
+
+#include <chrono>
+#include <cstdint>
+#include <functional>
+#include <random>
+#include <string>
+
+/**
+ * @brief Keeps the results of the timed calls alive so the compiler cannot drop them.
+ */
+inline volatile size_t benchSink = 0;
+
+/**
+ * @brief Builds a string of random decimal digits without a leading zero.
+ *
+ * Shared by the benchmark, the GMP comparison, the tuner and the regression harness.
+ *
+ * @param digits The number of digits.
+ * @param rng The random generator.
+ * @return The digit string.
+ */
+inline std::string randomDigits(size_t digits, std::mt19937_64& rng) {
+    std::uniform_int_distribution<int> digit(0, 9);
+    std::uniform_int_distribution<int> leading(1, 9);
+    std::string str(digits, '0');
+    str[0] = static_cast<char>('0' + leading(rng));
+    for (size_t i = 1; i < digits; ++i) {
+        str[i] = static_cast<char>('0' + digit(rng));
+    }
+    return str;
+}
+
+/**
+ * @brief Times one call repeatedly until the minimum time is reached.
+ *
+ * The calls run in batches that double in size, so the clock is read only a few times.
+ *
+ * @param call The call to time.
+ * @param minTime The minimum total time in seconds.
+ * @param iterations Receives the number of calls.
+ * @return The mean time of one call in nanoseconds.
+ */
+inline double timeCall(const std::function<void()>& call, double minTime, uint64_t& iterations) {
+    using Clock = std::chrono::steady_clock;
+    iterations = 0;
+    uint64_t batch = 1;
+    Clock::time_point start = Clock::now();
+    double elapsed = 0;
+    while (elapsed < minTime) {
+        for (uint64_t i = 0; i < batch; ++i) {
+            call();
+        }
+        iterations += batch;
+        elapsed = std::chrono::duration<double>(Clock::now() - start).count();
+        batch *= 2;
+    }
+    return elapsed * 1e9 / static_cast<double>(iterations);
+}
+
+/**
+ * @brief Times one call repeatedly until the minimum time is reached.
+ *
+ * @param call The call to time.
+ * @param minTime The minimum total time in seconds.
+ * @return The mean time of one call in nanoseconds.
+ */
+inline double timeCall(const std::function<void()>& call, double minTime) {
+    uint64_t iterations = 0;
+    return timeCall(call, minTime, iterations);
+}
+
+#endif
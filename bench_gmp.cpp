@@ -0,0 +1,214 @@
+#include <cstdint>
+#include <functional>
+#include <iomanip>
+#include <iostream>
+#include <memory>
+#include <random>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include "bench_common.hpp"
+#include "bigint.hpp"
+
+#include <gmp.h>
+
+/**
+ * @brief Owns an mpz_t for the lifetime of a benchmark.
+ */
+struct Mpz {
+    mpz_t value;
+
+    /**
+     * @brief Starts at zero, without parsing anything.
+     */
+    Mpz() {
+        mpz_init(value);
+    }
+
+    /**
+     * @brief Reads a decimal number.
+     *
+     * @param str The number in decimal.
+     */
+    explicit Mpz(const std::string& str) {
+        mpz_init_set_str(value, str.c_str(), 10);
+    }
+
+    Mpz(const Mpz&) = delete;
+    Mpz& operator=(const Mpz&) = delete;
+
+    ~Mpz() {
+        mpz_clear(value);
+    }
+};
+
+/**
+ * @brief One operation timed with both BigInt and GMP.
+ *
+ * Both prepare functions build their operands from the same two decimal strings, outside of
+ * the timed region, and return the call to time.
+ */
+struct GmpOperation {
+    std::string name;
+    std::function<std::function<void()>(const std::string&, const std::string&)> bigint;
+    std::function<std::function<void()>(const std::string&, const std::string&)> gmp;
+};
+
+/**
+ * @brief Lists the operations timed with both libraries.
+ *
+ * The divisions divide a number by one of half its length.
+ *
+ * @return The operations.
+ */
+std::vector<GmpOperation> gmpOperations() {
+    std::vector<GmpOperation> operations;
+    operations.push_back({"parse", [](const std::string& a, const std::string&) {
+        return std::function<void()>([a] { benchSink = benchSink + (BigInt(a) == BigInt(0) ? 0 : 1); });
+    }, [](const std::string& a, const std::string&) {
+        return std::function<void()>([a] {
+            mpz_t x;
+            mpz_init_set_str(x, a.c_str(), 10);
+            benchSink = benchSink + mpz_size(x);
+            mpz_clear(x);
+        });
+    }});
+    operations.push_back({"print", [](const std::string& a, const std::string&) {
+        BigInt x(a);
+        return std::function<void()>([x] {
+            std::ostringstream output;
+            output << x;
+            benchSink = benchSink + output.str().size();
+        });
+    }, [](const std::string& a, const std::string&) {
+        std::shared_ptr<Mpz> x = std::make_shared<Mpz>(a);
+        return std::function<void()>([x] {
+            std::string output(mpz_sizeinbase(x->value, 10) + 2, '\0');
+            mpz_get_str(output.data(), 10, x->value);
+            benchSink = benchSink + static_cast<size_t>(output[0]);
+        });
+    }});
+    operations.push_back({"add", [](const std::string& a, const std::string& b) {
+        BigInt x(a);
+        BigInt y(b);
+        return std::function<void()>([x, y] { benchSink = benchSink + ((x + y) == x ? 0 : 1); });
+    }, [](const std::string& a, const std::string& b) {
+        std::shared_ptr<Mpz> x = std::make_shared<Mpz>(a);
+        std::shared_ptr<Mpz> y = std::make_shared<Mpz>(b);
+        return std::function<void()>([x, y] {
+            Mpz z;
+            mpz_add(z.value, x->value, y->value);
+            benchSink = benchSink + mpz_size(z.value);
+        });
+    }});
+    operations.push_back({"subtract", [](const std::string& a, const std::string& b) {
+        BigInt x(a);
+        BigInt y(b);
+        return std::function<void()>([x, y] { benchSink = benchSink + ((x - y) == x ? 0 : 1); });
+    }, [](const std::string& a, const std::string& b) {
+        std::shared_ptr<Mpz> x = std::make_shared<Mpz>(a);
+        std::shared_ptr<Mpz> y = std::make_shared<Mpz>(b);
+        return std::function<void()>([x, y] {
+            Mpz z;
+            mpz_sub(z.value, x->value, y->value);
+            benchSink = benchSink + mpz_size(z.value);
+        });
+    }});
+    operations.push_back({"multiply", [](const std::string& a, const std::string& b) {
+        BigInt x(a);
+        BigInt y(b);
+        return std::function<void()>([x, y] { benchSink = benchSink + ((x * y) == x ? 0 : 1); });
+    }, [](const std::string& a, const std::string& b) {
+        std::shared_ptr<Mpz> x = std::make_shared<Mpz>(a);
+        std::shared_ptr<Mpz> y = std::make_shared<Mpz>(b);
+        return std::function<void()>([x, y] {
+            Mpz z;
+            mpz_mul(z.value, x->value, y->value);
+            benchSink = benchSink + mpz_size(z.value);
+        });
+    }});
+    operations.push_back({"divide", [](const std::string& a, const std::string& b) {
+        BigInt x(a);
+        BigInt y(b.substr(0, std::max<size_t>(b.size() / 2, 1)));
+        return std::function<void()>([x, y] { benchSink = benchSink + ((x / y) == x ? 0 : 1); });
+    }, [](const std::string& a, const std::string& b) {
+        std::shared_ptr<Mpz> x = std::make_shared<Mpz>(a);
+        std::shared_ptr<Mpz> y = std::make_shared<Mpz>(b.substr(0, std::max<size_t>(b.size() / 2, 1)));
+        return std::function<void()>([x, y] {
+            Mpz z;
+            mpz_tdiv_q(z.value, x->value, y->value);
+            benchSink = benchSink + mpz_size(z.value);
+        });
+    }});
+    operations.push_back({"compare", [](const std::string& a, const std::string&) {
+        BigInt x(a);
+        BigInt y = x + BigInt(1);
+        return std::function<void()>([x, y] { benchSink = benchSink + (x < y ? 1 : 0); });
+    }, [](const std::string& a, const std::string&) {
+        std::shared_ptr<Mpz> x = std::make_shared<Mpz>(a);
+        std::shared_ptr<Mpz> y = std::make_shared<Mpz>(a);
+        mpz_add_ui(y->value, y->value, 1);
+        return std::function<void()>([x, y] { benchSink = benchSink + (mpz_cmp(x->value, y->value) < 0 ? 1 : 0); });
+    }});
+    return operations;
+}
+
+/**
+ * @brief The main function of the differential benchmark against GMP.
+ *
+ * Times every operation with BigInt and with mpz_t at 10, 100, ... digits up to --max-digits,
+ * on the same operands, and prints one table per operation with the ratio of the BigInt time
+ * to the GMP time. An operation stops growing once its next BigInt call is predicted to take
+ * longer than --budget seconds.
+ *
+ * @param argc The number of arguments.
+ * @param argv The arguments: --max-digits N, --min-time S, --budget S.
+ * @return Returns 0 on success, 1 for invalid options.
+ */
+int main(int argc, char* argv[]) {
+    size_t maxDigits = 100000;
+    double minTime = 0.1;
+    double budget = 1.0;
+    bool valid = argc % 2 == 1;
+    for (int i = 1; valid && i + 1 < argc; i += 2) {
+        std::string arg = argv[i];
+        if (arg == "--max-digits") {
+            maxDigits = std::stoull(argv[i + 1]);
+        } else if (arg == "--min-time") {
+            minTime = std::stod(argv[i + 1]);
+        } else if (arg == "--budget") {
+            budget = std::stod(argv[i + 1]);
+        } else {
+            valid = false;
+        }
+    }
+    if (!valid) {
+        std::cerr << "Usage: bench_gmp [--max-digits N] [--min-time S] [--budget S]\n";
+        return 1;
+    }
+
+    std::cout << "GMP " << gmp_version << "\n";
+    std::mt19937_64 rng(67);
+    for (const GmpOperation& operation : gmpOperations()) {
+        std::cout << "\n" << operation.name << "\n"
+                  << std::setw(10) << "digits" << std::setw(16) << "bigint ns" << std::setw(16) << "gmp ns"
+                  << std::setw(12) << "ratio" << "\n";
+        double previous = 0;
+        for (size_t digits = 10; digits <= maxDigits; digits *= 10) {
+            std::string a = randomDigits(digits, rng);
+            std::string b = randomDigits(digits, rng);
+            double bigint = timeCall(operation.bigint(a, b), minTime);
+            double gmp = timeCall(operation.gmp(a, b), minTime);
+            std::cout << std::setw(10) << digits << std::fixed << std::setprecision(1) << std::setw(16) << bigint
+                      << std::setw(16) << gmp << std::setw(12) << bigint / gmp << "\n"
+                      << std::defaultfloat;
+            double growth = previous > 0 ? bigint / previous : 10.0;
+            previous = bigint;
+            if (bigint * std::max(growth, 1.0) > budget * 1e9) {
+                break;
+            }
+        }
+    }
+    return 0;
+}
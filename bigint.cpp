@@ -0,0 +1,1020 @@
+#include "bigint.hpp"
+
+template <std::floating_point Float>
+BigInt::BigInt(Float value) : BigInt() {
+    static_assert(std::numeric_limits<Float>::radix == 2, "Float must have a binary mantissa");
+    if (!std::isfinite(value)) {
+        throw std::invalid_argument("Not a finite number");
+    }
+    int exponent = 0;
+    Float mantissa = std::frexp(std::fabs(std::trunc(value)), &exponent);
+    int remaining = std::min(exponent, std::numeric_limits<Float>::digits);
+    while (remaining > 0) {
+        int step = std::min(remaining, 32);
+        mantissa = std::ldexp(mantissa, step);
+        Float chunk = std::trunc(mantissa);
+        mantissa -= chunk;
+        *this = *this * fromUnsigned(uint64_t(1) << step) + fromUnsigned(static_cast<uint64_t>(chunk));
+        remaining -= step;
+    }
+    if (exponent > std::numeric_limits<Float>::digits) {
+        *this = *this * pow(BigInt(2), static_cast<uint64_t>(exponent - std::numeric_limits<Float>::digits));
+    }
+    isNegative = value < 0 && !isZero();
+}
+
+template BigInt::BigInt(float);
+template BigInt::BigInt(double);
+template BigInt::BigInt(long double);
+
+std::tuple<BigInt, BigInt, BigInt> BigInt::gcdext(const BigInt& a, const BigInt& b) {
+    BigInt oldR = a.absolute();
+    BigInt r = b.absolute();
+    BigInt oldS(1);
+    BigInt s(0);
+    while (!r.isZero()) {
+        std::pair<BigInt, BigInt> division = absoluteDivide(oldR, r);
+        oldR = std::move(r);
+        r = std::move(division.second);
+        BigInt nextS = oldS - division.first * s;
+        oldS = std::move(s);
+        s = std::move(nextS);
+    }
+    if (a.isNegative) {
+        oldS = -oldS;
+    }
+    BigInt t;
+    if (!b.isZero()) {
+        t = (oldR - a * oldS) / b;
+    }
+    return {oldR, oldS, t};
+}
+
+BigInt BigInt::invert(const BigInt& a, const BigInt& m) {
+    if (m.isNegative || m.isZero()) {
+        throw std::invalid_argument("Modulus must be positive");
+    }
+    std::tuple<BigInt, BigInt, BigInt> result = gcdext(floorModulo(a, m), m);
+    if (std::get<0>(result) != BigInt(1)) {
+        throw std::invalid_argument("Not invertible");
+    }
+    return floorModulo(std::get<1>(result), m);
+}
+
+std::vector<BigInt> BigInt::batchInvert(const std::vector<BigInt>& values, const BigInt& m) {
+    std::vector<BigInt> inverses(values.size());
+    if (values.empty()) {
+        return inverses;
+    }
+    std::vector<BigInt> prefix(values.size());
+    prefix[0] = floorModulo(values[0], m);
+    for (size_t i = 1; i < values.size(); ++i) {
+        prefix[i] = floorModulo(prefix[i - 1] * values[i], m);
+    }
+    BigInt running = invert(prefix.back(), m);
+    for (size_t i = values.size() - 1; i > 0; --i) {
+        inverses[i] = floorModulo(running * prefix[i - 1], m);
+        running = floorModulo(running * values[i], m);
+    }
+    inverses[0] = running;
+    return inverses;
+}
+
+BigInt BigInt::powmod(const BigInt& base, const BigInt& exponent, const BigInt& m) {
+    if (exponent.isNegative) {
+        throw std::invalid_argument("Negative exponent");
+    }
+    if (m.isNegative || m.isZero()) {
+        throw std::invalid_argument("Modulus must be positive");
+    }
+    return powmod(base, exponent, buildBarrett(m));
+}
+
+BigInt BigInt::powmod(const BigInt& base, const BigInt& exponent, const BarrettModulus& modulus) {
+    std::vector<BigInt> powers(10);
+    powers[0] = barrettReduce(BigInt(1), modulus);
+    powers[1] = barrettReduce(base, modulus);
+    for (size_t i = 2; i < powers.size(); ++i) {
+        powers[i] = barrettReduce(powers[i - 1] * powers[1], modulus);
+    }
+
+    BigInt result = powers[0];
+    for (size_t i = exponent.number.size(); i > 0; --i) {
+        BigInt square = barrettReduce(result * result, modulus);
+        BigInt fifth = barrettReduce(barrettReduce(square * square, modulus) * result, modulus);
+        result = barrettReduce(fifth * fifth, modulus);
+        int64_t digit = exponent.number[i - 1];
+        if (digit != 0) {
+            result = barrettReduce(result * powers[static_cast<size_t>(digit)], modulus);
+        }
+    }
+    return result;
+}
+
+BigInt::BarrettModulus BigInt::buildBarrett(const BigInt& m) {
+    size_t digits = m.number.size();
+    return {m, absoluteDivide(powerOfTen(2 * digits), m).first, digits};
+}
+
+BigInt BigInt::barrettReduce(const BigInt& a, const BarrettModulus& modulus) {
+    size_t k = modulus.digits;
+    if (a.number.size() > 2 * k) {
+        return floorModulo(a, modulus.modulus);
+    }
+    if (a.isNegative) {
+        BigInt remainder = barrettReduce(a.absolute(), modulus);
+        return remainder.isZero() ? remainder : modulus.modulus - remainder;
+    }
+    // q = floor(floor(a / 10^(k-1)) * reciprocal / 10^(k+1)) is at most 2 below a / modulus.
+    BigInt quotient = shiftDigitsRight(shiftDigitsRight(a, k - 1) * modulus.reciprocal, k + 1);
+    BigInt remainder = a - quotient * modulus.modulus;
+    while (absoluteComparison(remainder, modulus.modulus) >= 0) {
+        remainder -= modulus.modulus;
+    }
+    return remainder;
+}
+
+BigInt BigInt::sqrt(const BigInt& n) {
+    if (n.isNegative) {
+        throw std::invalid_argument("Square root of a negative number");
+    }
+    if (n.isZero()) {
+        return n;
+    }
+    BigInt x;
+    x.number.assign((n.number.size() + 1) / 2 + 1, 0);
+    x.number.back() = 1;
+    while (true) {
+        BigInt next = divideSmall(x + n / x, 2);
+        if (next >= x) {
+            return x;
+        }
+        x = std::move(next);
+    }
+}
+
+bool BigInt::isProbablePrime(size_t rounds) const {
+    if (isNegative || absoluteComparison(*this, BigInt(2)) < 0) {
+        return false;
+    }
+    const std::vector<int64_t>& primes = smallPrimes();
+    size_t trialCount = std::min(primes.size(), static_cast<size_t>(168));
+    std::vector<int64_t> residues = smallResidues(*this, trialCount);
+    for (size_t i = 0; i < trialCount; ++i) {
+        if (residues[i] == 0) {
+            return *this == BigInt(primes[i]);
+        }
+    }
+    int64_t largest = primes[trialCount - 1];
+    if (*this < BigInt(largest * largest)) {
+        return true;
+    }
+
+    return passesBailliePSW(*this, rounds);
+}
+
+BigInt BigInt::nextPrime(size_t threads) const {
+    const std::vector<int64_t>& primes = smallPrimes();
+    BigInt start = *this + BigInt(1);
+    if (start <= BigInt(primes.back())) {
+        if (start <= BigInt(2)) {
+            return BigInt(2);
+        }
+        int64_t value = remainderSmall(start, smallDivisorLimit);
+        return BigInt(*std::lower_bound(primes.begin(), primes.end(), value));
+    }
+    if (start.number[0] % 2 == 0) {
+        ++start;
+    }
+    threads = std::max(threads, static_cast<size_t>(1));
+
+    std::vector<int64_t> residues = smallResidues(start, primes.size());
+    std::vector<bool> composite(sieveWindow);
+    while (true) {
+        std::fill(composite.begin(), composite.end(), false);
+        for (size_t i = 1; i < primes.size(); ++i) {
+            int64_t p = primes[i];
+            int64_t offset = (p - residues[i]) % p * ((p + 1) / 2) % p;
+            for (size_t j = static_cast<size_t>(offset); j < sieveWindow; j += static_cast<size_t>(p)) {
+                composite[j] = true;
+            }
+        }
+
+        std::vector<size_t> survivors;
+        for (size_t j = 0; j < sieveWindow; ++j) {
+            if (!composite[j]) {
+                survivors.push_back(j);
+            }
+        }
+        for (size_t first = 0; first < survivors.size(); first += threads) {
+            size_t last = std::min(first + threads, survivors.size());
+            std::vector<std::future<bool>> results;
+            for (size_t k = first; k < last; ++k) {
+                BigInt candidate = start + BigInt(static_cast<int64_t>(2 * survivors[k]));
+                std::launch policy = threads > 1 ? std::launch::async : std::launch::deferred;
+                results.push_back(std::async(policy, [candidate] {
+                    return passesBailliePSW(candidate, 0);
+                }));
+            }
+            for (size_t k = first; k < last; ++k) {
+                if (results[k - first].get()) {
+                    return start + BigInt(static_cast<int64_t>(2 * survivors[k]));
+                }
+            }
+        }
+
+        start += BigInt(static_cast<int64_t>(2 * sieveWindow));
+        for (size_t i = 0; i < primes.size(); ++i) {
+            residues[i] = (residues[i] + static_cast<int64_t>(2 * sieveWindow)) % primes[i];
+        }
+    }
+}
+
+BigInt BigInt::factorial(uint64_t n) {
+    std::vector<uint64_t> primes = primesUpTo(n);
+    std::vector<uint64_t> exponents(primes.size());
+    for (size_t i = 0; i < primes.size(); ++i) {
+        exponents[i] = legendreExponent(n, primes[i]);
+    }
+    return productOfPrimePowers(primes, exponents);
+}
+
+BigInt BigInt::doubleFactorial(uint64_t n) {
+    uint64_t k = n / 2;
+    std::vector<uint64_t> primes = primesUpTo(n);
+    std::vector<uint64_t> exponents(primes.size());
+    for (size_t i = 0; i < primes.size(); ++i) {
+        if (n % 2 == 0) {
+            exponents[i] = legendreExponent(k, primes[i]) + (primes[i] == 2 ? k : 0);
+        } else if (primes[i] != 2) {
+            exponents[i] = legendreExponent(n, primes[i]) - legendreExponent(k, primes[i]);
+        }
+    }
+    return productOfPrimePowers(primes, exponents);
+}
+
+BigInt BigInt::primorial(uint64_t n) {
+    std::vector<uint64_t> primes = primesUpTo(n);
+    return productOfPrimePowers(primes, std::vector<uint64_t>(primes.size(), 1));
+}
+
+BigInt BigInt::binomial(uint64_t n, uint64_t k) {
+    if (k > n) {
+        return BigInt();
+    }
+    return multinomial({k, n - k});
+}
+
+BigInt BigInt::multinomial(const std::vector<uint64_t>& parts) {
+    uint64_t n = 0;
+    for (uint64_t part : parts) {
+        n += part;
+    }
+    std::vector<uint64_t> primes = primesUpTo(n);
+    std::vector<uint64_t> exponents(primes.size());
+    for (size_t i = 0; i < primes.size(); ++i) {
+        exponents[i] = legendreExponent(n, primes[i]);
+        for (uint64_t part : parts) {
+            exponents[i] -= legendreExponent(part, primes[i]);
+        }
+    }
+    return productOfPrimePowers(primes, exponents);
+}
+
+BigInt BigInt::fibonacci(uint64_t n) {
+    return fibonacciLucas(n).first;
+}
+
+BigInt BigInt::lucas(uint64_t n) {
+    return fibonacciLucas(n).second;
+}
+
+BigInt BigInt::piDigits(uint64_t digits, size_t parallelDepth) {
+    const uint64_t guard = 10;
+    uint64_t precision = digits + guard;
+    uint64_t terms = precision / 14 + 2;
+    auto pTerm = [](uint64_t n) {
+        int64_t k = static_cast<int64_t>(n);
+        return -(BigInt(6 * k - 5) * BigInt(2 * k - 1) * BigInt(6 * k - 1));
+    };
+    auto qTerm = [](uint64_t n) {
+        BigInt k(static_cast<int64_t>(n));
+        return BigInt(10939058860032000) * k * k * k;
+    };
+    auto tTerm = [&pTerm](uint64_t n) {
+        return pTerm(n) * (BigInt(13591409) + BigInt(545140134) * BigInt(static_cast<int64_t>(n)));
+    };
+    auto [p, q, t] = binarySplit(1, terms, pTerm, qTerm, tTerm, parallelDepth);
+
+    BigInt root = sqrt(BigInt(10005) * powerOfTen(static_cast<size_t>(2 * precision)));
+    BigInt pi = BigInt(426880) * root * q / (BigInt(13591409) * q + t);
+    return pi / powerOfTen(static_cast<size_t>(guard));
+}
+
+BigInt::ModuliTree BigInt::buildModuliTree(std::span<const uint64_t> moduli) {
+    if (moduli.empty()) {
+        throw std::invalid_argument("No moduli");
+    }
+    ModuliTree tree;
+    tree.moduli.assign(moduli.begin(), moduli.end());
+    tree.levels.emplace_back();
+    for (uint64_t modulus : moduli) {
+        if (modulus < 2) {
+            throw std::invalid_argument("Modulus must be greater than 1");
+        }
+        tree.levels[0].push_back(fromUnsigned(modulus));
+    }
+    while (tree.levels.back().size() > 1) {
+        const std::vector<BigInt>& below = tree.levels.back();
+        std::vector<BigInt> above;
+        for (size_t i = 0; i < below.size(); i += 2) {
+            above.push_back(i + 1 < below.size() ? below[i] * below[i + 1] : below[i]);
+        }
+        tree.levels.push_back(std::move(above));
+    }
+
+    std::vector<BigInt> outside = {BigInt(1)};
+    for (size_t level = tree.levels.size() - 1; level > 0; --level) {
+        const std::vector<BigInt>& children = tree.levels[level - 1];
+        std::vector<BigInt> next(children.size());
+        for (size_t i = 0; i < children.size(); ++i) {
+            BigInt rest = outside[i / 2];
+            size_t sibling = i ^ 1;
+            if (sibling < children.size()) {
+                rest = rest * children[sibling];
+            }
+            next[i] = floorModulo(rest, children[i]);
+        }
+        outside = std::move(next);
+    }
+    for (size_t i = 0; i < moduli.size(); ++i) {
+        tree.inverses.push_back(toUnsigned(invert(outside[i], tree.levels[0][i])));
+    }
+    return tree;
+}
+
+BigInt BigInt::crt(std::span<const uint64_t> residues, std::span<const uint64_t> moduli) {
+    return crt(residues, buildModuliTree(moduli));
+}
+
+BigInt BigInt::crt(std::span<const uint64_t> residues, const ModuliTree& tree) {
+    if (residues.size() != tree.moduli.size()) {
+        throw std::invalid_argument("Residues and moduli have different sizes");
+    }
+    std::vector<BigInt> values(residues.size());
+    for (size_t i = 0; i < residues.size(); ++i) {
+        BigInt product = fromUnsigned(residues[i]) * fromUnsigned(tree.inverses[i]);
+        values[i] = floorModulo(product, tree.levels[0][i]);
+    }
+    for (size_t level = 0; level + 1 < tree.levels.size(); ++level) {
+        const std::vector<BigInt>& nodes = tree.levels[level];
+        std::vector<BigInt> merged;
+        for (size_t i = 0; i < values.size(); i += 2) {
+            if (i + 1 < values.size()) {
+                merged.push_back(values[i] * nodes[i + 1] + values[i + 1] * nodes[i]);
+            } else {
+                merged.push_back(values[i]);
+            }
+        }
+        values = std::move(merged);
+    }
+    return floorModulo(values[0], tree.levels.back()[0]);
+}
+
+std::vector<uint64_t> BigInt::multiMod(const BigInt& x, std::span<const uint64_t> moduli) {
+    return multiMod(x, buildModuliTree(moduli));
+}
+
+std::vector<uint64_t> BigInt::multiMod(const BigInt& x, const ModuliTree& tree) {
+    std::vector<BigInt> remainders = {floorModulo(x, tree.levels.back()[0])};
+    for (size_t level = tree.levels.size() - 1; level > 0; --level) {
+        const std::vector<BigInt>& children = tree.levels[level - 1];
+        std::vector<BigInt> next(children.size());
+        for (size_t i = 0; i < children.size(); ++i) {
+            next[i] = remainders[i / 2] % children[i];
+        }
+        remainders = std::move(next);
+    }
+    std::vector<uint64_t> residues;
+    for (const BigInt& remainder : remainders) {
+        residues.push_back(toUnsigned(remainder));
+    }
+    return residues;
+}
+
+BigInt BigInt::pow(const BigInt& base, uint64_t exponent) {
+    BigInt result(1);
+    BigInt square = base;
+    while (exponent != 0) {
+        if ((exponent & 1) != 0) {
+            result *= square;
+        }
+        exponent >>= 1;
+        if (exponent != 0) {
+            square = square * square;
+        }
+    }
+    return result;
+}
+
+double BigInt::toDouble() const {
+    double answer = 0;
+    if (number.size() <= 19) {
+        answer = static_cast<double>(toUnsigned(*this));
+    } else if (number.size() > 309) {
+        answer = std::numeric_limits<double>::infinity();
+    } else {
+        int shift = static_cast<int>(log2()) - 60;
+        std::pair<BigInt, BigInt> division = absoluteDivide(*this, pow(BigInt(2), static_cast<uint64_t>(shift)));
+        uint64_t top = toUnsigned(division.first);
+        int extra = static_cast<int>(std::bit_width(top)) - 53;
+        uint64_t mantissa = top >> extra;
+        uint64_t dropped = top & ((uint64_t(1) << extra) - 1);
+        uint64_t half = uint64_t(1) << (extra - 1);
+        bool sticky = !division.second.isZero();
+        if (dropped > half || (dropped == half && (sticky || (mantissa & 1) != 0))) {
+            ++mantissa;
+        }
+        answer = std::ldexp(static_cast<double>(mantissa), shift + extra);
+    }
+    return isNegative ? -answer : answer;
+}
+
+double BigInt::log2() const {
+    return log10() * std::log2(10.0);
+}
+
+double BigInt::log10() const {
+    if (isZero()) {
+        return -std::numeric_limits<double>::infinity();
+    }
+    size_t leading = std::min(number.size(), static_cast<size_t>(19));
+    uint64_t top = 0;
+    for (size_t i = 0; i < leading; ++i) {
+        top = top * 10 + static_cast<uint64_t>(number[number.size() - 1 - i]);
+    }
+    return std::log10(static_cast<double>(top)) + static_cast<double>(number.size() - leading);
+}
+
+std::pair<BigInt, BigInt> BigInt::absoluteDivide(const BigInt& a, const BigInt& b) {
+    if (absoluteComparison(a, b) < 0) {
+        return {BigInt(), a.absolute()};
+    }
+    BIGINT_SCOPE(BigIntOperation::Divide, (a.number.size() - b.number.size() + 1) * b.number.size(),
+                 (a.number.size() + b.number.size() + 1) * sizeof(int64_t));
+
+    const Digits& divisor = b.number;
+    size_t length = divisor.size();
+    size_t leading = std::min(length, static_cast<size_t>(16));
+    int64_t divisorTop = 0;
+    for (size_t i = 0; i < leading; ++i) {
+        divisorTop = divisorTop * 10 + divisor[length - 1 - i];
+    }
+
+    // The running remainder is the window rest[low, high) of a copy of a: bringing down the
+    // next digit only moves low, and the subtractions work in place inside the window.
+    BigInt quotient;
+    quotient.number.assign(a.number.size(), 0);
+    Digits rest = a.number;
+    size_t high = rest.size();
+    for (size_t i = a.number.size(); i > 0; --i) {
+        size_t low = i - 1;
+        while (high > low && rest[high - 1] == 0) {
+            --high;
+        }
+        size_t size = high - low;
+        if (size < length) {
+            continue;
+        }
+
+        size_t extra = size - length;
+        int64_t remainderTop = 0;
+        for (size_t j = 0; j < leading + extra; ++j) {
+            remainderTop = remainderTop * 10 + rest[high - 1 - j];
+        }
+        int64_t digit = std::min(remainderTop / divisorTop, static_cast<int64_t>(9));
+        if (digit == 0) {
+            continue;
+        }
+
+        int64_t borrow = 0;
+        for (size_t j = 0; j < size; ++j) {
+            int64_t temp = borrow;
+            if (j < length) {
+                temp += digit * divisor[j];
+            }
+            int64_t diff = rest[low + j] - temp;
+            borrow = 0;
+            if (diff < 0) {
+                borrow = (9 - diff) / 10;
+                diff += borrow * 10;
+            }
+            rest[low + j] = diff;
+        }
+        if (borrow != 0) {
+            --digit;
+            int64_t carry = 0;
+            for (size_t j = 0; j < size; ++j) {
+                int64_t sum = rest[low + j] + carry;
+                if (j < length) {
+                    sum += divisor[j];
+                }
+                rest[low + j] = sum % 10;
+                carry = sum / 10;
+            }
+        }
+        quotient.number[i - 1] = digit;
+    }
+
+    quotient.removeLeadingZero();
+    while (high > 0 && rest[high - 1] == 0) {
+        --high;
+    }
+    BigInt remainder;
+    if (high > 0) {
+        rest.resize(high);
+        remainder.number = std::move(rest);
+    }
+    return {quotient, remainder};
+}
+
+const std::vector<int64_t>& BigInt::smallPrimes() {
+    static const std::vector<int64_t> primes = [] {
+        std::vector<int64_t> table;
+        std::vector<bool> composite(65536, false);
+        for (size_t i = 2; i < composite.size(); ++i) {
+            if (composite[i]) {
+                continue;
+            }
+            table.push_back(static_cast<int64_t>(i));
+            for (size_t j = i * i; j < composite.size(); j += i) {
+                composite[j] = true;
+            }
+        }
+        return table;
+    }();
+    return primes;
+}
+
+std::vector<int64_t> BigInt::smallResidues(const BigInt& a, size_t count) {
+    const std::vector<int64_t>& primes = smallPrimes();
+    std::vector<int64_t> residues(count);
+    size_t first = 0;
+    while (first < count) {
+        int64_t product = primes[first];
+        size_t last = first + 1;
+        while (last < count && product <= smallDivisorLimit / primes[last]) {
+            product *= primes[last];
+            ++last;
+        }
+        int64_t groupResidue = remainderSmall(a, product);
+        for (size_t i = first; i < last; ++i) {
+            residues[i] = groupResidue % primes[i];
+        }
+        first = last;
+    }
+    return residues;
+}
+
+bool BigInt::passesBailliePSW(const BigInt& n, size_t rounds) {
+    BarrettModulus modulus = buildBarrett(n);
+    if (!millerRabin(modulus, BigInt(2)) || !strongLucas(modulus)) {
+        return false;
+    }
+    const std::vector<int64_t>& primes = smallPrimes();
+    for (size_t i = 1; i <= rounds && i < primes.size(); ++i) {
+        if (!millerRabin(modulus, BigInt(primes[i]))) {
+            return false;
+        }
+    }
+    return true;
+}
+
+size_t BigInt::splitPowerOfTwo(const BigInt& value, BigInt& d) {
+    size_t s = 0;
+    d = value;
+    while (!d.isZero() && d.number[0] % 2 == 0) {
+        d = divideSmall(d, 2);
+        ++s;
+    }
+    return s;
+}
+
+bool BigInt::millerRabin(const BarrettModulus& modulus, const BigInt& base) {
+    BigInt nMinusOne = modulus.modulus - BigInt(1);
+    BigInt d;
+    size_t s = splitPowerOfTwo(nMinusOne, d);
+    BigInt x = powmod(base, d, modulus);
+    if (x == BigInt(1) || x == nMinusOne) {
+        return true;
+    }
+    for (size_t r = 1; r < s; ++r) {
+        x = barrettReduce(x * x, modulus);
+        if (x == nMinusOne) {
+            return true;
+        }
+    }
+    return false;
+}
+
+int BigInt::jacobi(int64_t a, const BigInt& n) {
+    int64_t nMod8 = remainderSmall(n, 8);
+    int result = 1;
+    if (a < 0) {
+        a = -a;
+        if (nMod8 % 4 == 3) {
+            result = -result;
+        }
+    }
+    while (a != 0 && a % 2 == 0) {
+        a /= 2;
+        if (nMod8 == 3 || nMod8 == 5) {
+            result = -result;
+        }
+    }
+    if (a == 1) {
+        return result;
+    }
+    if (a == 0) {
+        return 0;
+    }
+    if (a % 4 == 3 && nMod8 % 4 == 3) {
+        result = -result;
+    }
+    int64_t top = remainderSmall(n, a);
+    int64_t bottom = a;
+    while (top != 0) {
+        while (top % 2 == 0) {
+            top /= 2;
+            if (bottom % 8 == 3 || bottom % 8 == 5) {
+                result = -result;
+            }
+        }
+        std::swap(top, bottom);
+        if (top % 4 == 3 && bottom % 4 == 3) {
+            result = -result;
+        }
+        top %= bottom;
+    }
+    return bottom == 1 ? result : 0;
+}
+
+BigInt BigInt::halveModulo(const BigInt& x, const BigInt& n) {
+    if (x.number[0] % 2 != 0) {
+        return divideSmall(x + n, 2);
+    }
+    return divideSmall(x, 2);
+}
+
+bool BigInt::strongLucas(const BarrettModulus& modulus) {
+    const BigInt& n = modulus.modulus;
+    BigInt root = sqrt(n);
+    if (root * root == n) {
+        return false;
+    }
+    int64_t discriminant = 5;
+    while (true) {
+        int symbol = jacobi(discriminant, n);
+        if (symbol == -1) {
+            break;
+        }
+        if (symbol == 0 && absoluteComparison(n, BigInt(std::abs(discriminant))) != 0) {
+            return false;
+        }
+        discriminant = discriminant > 0 ? -(discriminant + 2) : -discriminant + 2;
+    }
+    BigInt d;
+    size_t s = splitPowerOfTwo(n + BigInt(1), d);
+    std::vector<int> bits;
+    for (BigInt rest = d; !rest.isZero(); rest = divideSmall(rest, 2)) {
+        bits.push_back(static_cast<int>(rest.number[0] % 2));
+    }
+
+    BigInt bigD = barrettReduce(BigInt(discriminant), modulus);
+    BigInt q = barrettReduce(BigInt((1 - discriminant) / 4), modulus);
+    BigInt u(1);
+    BigInt v(1);
+    BigInt qk = q;
+    for (size_t i = bits.size() - 1; i > 0; --i) {
+        u = barrettReduce(u * v, modulus);
+        v = barrettReduce(v * v - qk - qk, modulus);
+        qk = barrettReduce(qk * qk, modulus);
+        if (bits[i - 1] != 0) {
+            BigInt nextU = halveModulo(barrettReduce(u + v, modulus), n);
+            v = halveModulo(barrettReduce(bigD * u + v, modulus), n);
+            u = std::move(nextU);
+            qk = barrettReduce(qk * q, modulus);
+        }
+    }
+    if (u.isZero() || v.isZero()) {
+        return true;
+    }
+    for (size_t r = 1; r < s; ++r) {
+        v = barrettReduce(v * v - qk - qk, modulus);
+        if (v.isZero()) {
+            return true;
+        }
+        qk = barrettReduce(qk * qk, modulus);
+    }
+    return false;
+}
+
+std::vector<uint64_t> BigInt::primesUpTo(uint64_t n) {
+    std::vector<uint64_t> primes;
+    if (n < 2) {
+        return primes;
+    }
+    std::vector<bool> composite(static_cast<size_t>(n) + 1, false);
+    for (uint64_t i = 2; i <= n; ++i) {
+        if (composite[static_cast<size_t>(i)]) {
+            continue;
+        }
+        primes.push_back(i);
+        for (uint64_t j = i * i; j <= n; j += i) {
+            composite[static_cast<size_t>(j)] = true;
+        }
+    }
+    return primes;
+}
+
+uint64_t BigInt::legendreExponent(uint64_t n, uint64_t p) {
+    uint64_t exponent = 0;
+    while (n >= p) {
+        n /= p;
+        exponent += n;
+    }
+    return exponent;
+}
+
+BigInt BigInt::balancedProduct(const std::vector<BigInt>& factors, size_t first, size_t last) {
+    if (first >= last) {
+        return BigInt(1);
+    }
+    if (last - first == 1) {
+        return factors[first];
+    }
+    BIGINT_SCOPE(BigIntOperation::ProductTree, last - first, 0);
+    size_t middle = first + (last - first) / 2;
+    return balancedProduct(factors, first, middle) * balancedProduct(factors, middle, last);
+}
+
+BigInt BigInt::productOfPrimePowers(const std::vector<uint64_t>& primes, const std::vector<uint64_t>& exponents) {
+    uint64_t maxExponent = 0;
+    for (uint64_t exponent : exponents) {
+        maxExponent = std::max(maxExponent, exponent);
+    }
+    int bit = 0;
+    while (bit < 63 && (maxExponent >> (bit + 1)) != 0) {
+        ++bit;
+    }
+
+    BigInt result(1);
+    for (; bit >= 0; --bit) {
+        result = result * result;
+        std::vector<BigInt> factors;
+        int64_t word = 1;
+        for (size_t i = 0; i < primes.size(); ++i) {
+            if (((exponents[i] >> bit) & 1) == 0) {
+                continue;
+            }
+            int64_t p = static_cast<int64_t>(primes[i]);
+            if (word > INT64_MAX / p) {
+                factors.push_back(BigInt(word));
+                word = 1;
+            }
+            word *= p;
+        }
+        if (word != 1) {
+            factors.push_back(BigInt(word));
+        }
+        if (!factors.empty()) {
+            result = result * balancedProduct(factors, 0, factors.size());
+        }
+    }
+    return result;
+}
+
+std::pair<BigInt, BigInt> BigInt::fibonacciLucas(uint64_t n) {
+    BigInt f(0);
+    BigInt l(2);
+    bool odd = false;
+    int bit = 63;
+    while (bit >= 0 && ((n >> bit) & 1) == 0) {
+        --bit;
+    }
+    for (; bit >= 0; --bit) {
+        f = f * l;
+        l = l * l;
+        if (odd) {
+            l += BigInt(2);
+        } else {
+            l -= BigInt(2);
+        }
+        odd = false;
+        if (((n >> bit) & 1) != 0) {
+            BigInt nextF = divideSmall(f + l, 2);
+            l = divideSmall(f * BigInt(5) + l, 2);
+            f = std::move(nextF);
+            odd = true;
+        }
+    }
+    return {std::move(f), std::move(l)};
+}
+
+BigInt BigInt::powerOfTen(size_t k) {
+    BigInt answer;
+    answer.number.assign(k + 1, 0);
+    answer.number.back() = 1;
+    return answer;
+}
+
+const BigInt& BigInt::powerOfTwo(uint64_t k) {
+    thread_local uint64_t cachedExponent = 0;
+    thread_local BigInt cachedPower(1);
+    if (cachedExponent != k) {
+        cachedPower = pow(BigInt(2), k);
+        cachedExponent = k;
+    }
+    return cachedPower;
+}
+
+void BigInt::multiplyDigits(const int64_t* a, size_t n, const int64_t* b, size_t m, int64_t* out) {
+    if (n < m) {
+        std::swap(a, b);
+        std::swap(n, m);
+    }
+    if (m < std::max(karatsubaThreshold(), static_cast<size_t>(2))) {
+        multiplySchoolbook(a, n, b, m, out);
+        return;
+    }
+    if (2 * m <= n) {
+        for (size_t i = 0; i < n; i += m) {
+            multiplyDigits(a + i, std::min(m, n - i), b, m, out + i);
+        }
+        return;
+    }
+
+    size_t half = n / 2;
+    [[maybe_unused]] size_t temporaries = 2 * (n - half + std::max(half, m - half)) + n + m;
+    BIGINT_SCOPE(BigIntOperation::MultiplyKaratsuba, temporaries, temporaries * sizeof(int64_t));
+    Digits sumA(n - half);
+    Digits sumB(std::max(half, m - half));
+    for (size_t i = 0; i < sumA.size(); ++i) {
+        sumA[i] = a[half + i] + (i < half ? a[i] : 0);
+    }
+    for (size_t i = 0; i < sumB.size(); ++i) {
+        sumB[i] = (i < half ? b[i] : 0) + (i < m - half ? b[half + i] : 0);
+    }
+
+    Digits low(2 * half, 0);
+    Digits high(n + m - 2 * half, 0);
+    Digits middle(sumA.size() + sumB.size(), 0);
+    multiplyDigits(a, half, b, half, low.data());
+    multiplyDigits(a + half, n - half, b + half, m - half, high.data());
+    multiplyDigits(sumA.data(), sumA.size(), sumB.data(), sumB.size(), middle.data());
+
+    for (size_t i = 0; i < low.size(); ++i) {
+        out[i] += low[i];
+        middle[i] -= low[i];
+    }
+    for (size_t i = 0; i < high.size(); ++i) {
+        out[2 * half + i] += high[i];
+        middle[i] -= high[i];
+    }
+    for (size_t i = 0; i < middle.size(); ++i) {
+        out[half + i] += middle[i];
+    }
+}
+
+void BigInt::sort(std::span<BigInt> values, size_t threads) {
+    if (values.size() < 2) {
+        return;
+    }
+    std::vector<SortEntry> entries(values.size());
+    for (size_t i = 0; i < values.size(); ++i) {
+        entries[i] = {sortKey(values[i], 0), i};
+    }
+    std::vector<SortEntry> buffer(values.size());
+    radixSort(values, entries, buffer, 0, 56, std::max<size_t>(threads, 1));
+
+    std::vector<BigInt> sorted;
+    sorted.reserve(values.size());
+    for (const SortEntry& entry : entries) {
+        sorted.push_back(std::move(values[entry.index]));
+    }
+    std::move(sorted.begin(), sorted.end(), values.begin());
+}
+
+uint64_t BigInt::sortKey(const BigInt& value, size_t word) {
+    size_t size = value.number.size();
+    if (word == 0) {
+        uint64_t middle = uint64_t{1} << 63;
+        return value.isNegative ? middle - size : middle + size;
+    }
+    // 10^19 - 1 still fits in a uint64_t, so a word holds 19 digits.
+    constexpr size_t wordDigits = 19;
+    size_t top = size - (word - 1) * wordDigits;
+    uint64_t chunk = 0;
+    for (size_t k = 0; k < wordDigits; ++k) {
+        chunk = chunk * 10 + (k < top ? static_cast<uint64_t>(value.number[top - 1 - k]) : 0);
+    }
+    return value.isNegative ? ~chunk : chunk;
+}
+
+void BigInt::radixSort(std::span<BigInt> values, std::span<SortEntry> entries, std::span<SortEntry> buffer,
+                       size_t word, int shift, size_t threads) {
+    constexpr size_t comparisonCutoff = 64;
+    constexpr size_t wordDigits = 19;
+    while (true) {
+        if (entries.size() < comparisonCutoff) {
+            std::sort(entries.begin(), entries.end(), [&values](const SortEntry& a, const SortEntry& b) {
+                if (a.key != b.key) {
+                    return a.key < b.key;
+                }
+                return values[a.index] < values[b.index];
+            });
+            return;
+        }
+        if (shift < 0) {
+            // Every value here has the same sign and length, so the same number of words.
+            ++word;
+            if (word > (values[entries[0].index].number.size() + wordDigits - 1) / wordDigits) {
+                return;
+            }
+            for (SortEntry& entry : entries) {
+                entry.key = sortKey(values[entry.index], word);
+            }
+            shift = 56;
+        }
+
+        std::array<size_t, 257> offsets{};
+        for (const SortEntry& entry : entries) {
+            ++offsets[((entry.key >> shift) & 255) + 1];
+        }
+        if (std::find(offsets.begin(), offsets.end(), entries.size()) != offsets.end()) {
+            shift -= 8;
+            continue;
+        }
+        for (size_t b = 1; b < offsets.size(); ++b) {
+            offsets[b] += offsets[b - 1];
+        }
+        std::copy(entries.begin(), entries.end(), buffer.begin());
+        std::array<size_t, 256> next;
+        std::copy(offsets.begin(), offsets.end() - 1, next.begin());
+        for (const SortEntry& entry : buffer.first(entries.size())) {
+            entries[next[(entry.key >> shift) & 255]++] = entry;
+        }
+
+        std::vector<size_t> buckets;
+        for (size_t b = 0; b < 256; ++b) {
+            if (offsets[b + 1] - offsets[b] > 1) {
+                buckets.push_back(b);
+            }
+        }
+        auto sortBucket = [&](size_t b, size_t bucketThreads) {
+            size_t first = offsets[b];
+            size_t count = offsets[b + 1] - first;
+            radixSort(values, entries.subspan(first, count), buffer.subspan(first, count), word, shift - 8, bucketThreads);
+        };
+        if (threads <= 1 || buckets.size() < 2) {
+            for (size_t b : buckets) {
+                sortBucket(b, threads);
+            }
+            return;
+        }
+
+        if (buckets.size() < threads) {
+            // Too few buckets to keep every thread busy: each bucket gets its own thread and a
+            // share of the threads proportional to its size, to fork again at its next split.
+            std::vector<std::future<void>> workers;
+            for (size_t b : buckets) {
+                size_t share = std::max<size_t>(threads * (offsets[b + 1] - offsets[b]) / entries.size(), 1);
+                workers.push_back(std::async(std::launch::async, [&sortBucket, b, share] {
+                    sortBucket(b, share);
+                }));
+            }
+            for (std::future<void>& worker : workers) {
+                worker.get();
+            }
+            return;
+        }
+
+        // The largest buckets are handed out first, so one large bucket does not finish last.
+        std::sort(buckets.begin(), buckets.end(), [&offsets](size_t a, size_t b) {
+            return offsets[a + 1] - offsets[a] > offsets[b + 1] - offsets[b];
+        });
+        std::atomic<size_t> taken = 0;
+        std::vector<std::future<void>> workers;
+        for (size_t t = 0; t < std::min(threads, buckets.size()); ++t) {
+            workers.push_back(std::async(std::launch::async, [&] {
+                for (size_t k = taken++; k < buckets.size(); k = taken++) {
+                    sortBucket(buckets[k], 1);
+                }
+            }));
+        }
+        for (std::future<void>& worker : workers) {
+            worker.get();
+        }
+        return;
+    }
+}
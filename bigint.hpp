@@ -6,6 +6,323 @@
 #include <string>
 #include <stdexcept>
 #include <algorithm>
+#include <tuple>
+#include <utility>
+#include <future>
+#include <cstdint>
+#include <span>
+#include <random>
+#include <cmath>
+#include <concepts>
+#include <limits>
+#include <bit>
+#include <array>
+#include <atomic>
+#include <compare>
+#include <functional>
+#include <sstream>
+#include <iomanip>
+
+#if (defined(BIGINT_TRACK_ALLOCATIONS) || defined(BIGINT_TRACE)) && !defined(BIGINT_INSTRUMENT)
+#define BIGINT_INSTRUMENT
+#endif
+
+#ifdef BIGINT_INSTRUMENT
+#include <chrono>
+#endif
+
+#ifdef BIGINT_TRACE
+#include <mutex>
+#endif
+
+/**
+ * @brief The number of digits from which multiplication switches to Karatsuba.
+ *
+ * bigint_tune measures it on the local host. It has to be the same for bigint.cpp and every
+ * file that includes bigint.hpp, so it is only set on the command line, as CMake does from
+ * the tuner's result.
+ */
+#ifndef BIGINT_KARATSUBA_THRESHOLD
+#define BIGINT_KARATSUBA_THRESHOLD 48
+#endif
+
+/**
+ * @brief The number of trace events kept with BIGINT_TRACE by the running threads together, and
+ * again for the threads that ended; the oldest are overwritten.
+ */
+#ifndef BIGINT_TRACE_CAPACITY
+#define BIGINT_TRACE_CAPACITY 65536
+#endif
+
+/**
+ * @brief Counts the enclosing operation when BIGINT_INSTRUMENT is defined, and does nothing otherwise.
+ *
+ * The arguments are not evaluated when the instrumentation is off.
+ */
+#ifdef BIGINT_INSTRUMENT
+#define BIGINT_SCOPE(operation, digitOperations, bytes) BigInt::Scope instrumentScope(operation, digitOperations, bytes)
+#else
+#define BIGINT_SCOPE(operation, digitOperations, bytes) static_cast<void>(0)
+#endif
+
+/**
+ * @brief The operations and algorithm tiers counted by the instrumentation.
+ */
+enum class BigIntOperation : size_t {
+    Add,
+    Subtract,
+    Multiply,
+    MultiplySchoolbook,
+    MultiplyKaratsuba,
+    Divide,
+    DivideSmall,
+    Parse,
+    Print,
+    BinarySplit,
+    ProductTree,
+    Other,
+    Count
+};
+
+/**
+ * @brief The counters of one operation.
+ *
+ * digitOperations is the number of digit steps of the algorithm, such as n * m for the
+ * schoolbook multiplication, or the number of terms for binary splitting and product trees. bytes is the size of the digit buffers the operation allocates.
+ * nanoseconds excludes the time spent in nested counted operations, so the times of the
+ * tiers add up to the total.
+ *
+ * The allocation counters are measured by the allocator of the digits and are only filled
+ * with BIGINT_TRACK_ALLOCATIONS. Allocations outside of every counted operation, such as
+ * copies of BigInts, go to BigIntOperation::Other. peakBytes is the most memory the operation
+ * held at once above what was allocated when it started, including its nested operations;
+ * for BigIntOperation::Other it is the largest single allocation.
+ */
+struct BigIntCounter {
+    uint64_t calls = 0;
+    uint64_t digitOperations = 0;
+    uint64_t bytes = 0;
+    uint64_t nanoseconds = 0;
+    uint64_t allocations = 0;
+    uint64_t deallocations = 0;
+    uint64_t allocatedBytes = 0;
+    uint64_t peakBytes = 0;
+};
+
+/**
+ * @brief A snapshot of the counters of one thread, returned by BigInt::statistics().
+ *
+ * currentBytes and peakBytes are the digit memory held by the thread now and at most, with
+ * BIGINT_TRACK_ALLOCATIONS. Memory freed by another thread than the one that allocated it
+ * is subtracted there, so currentBytes can go below zero in a thread that only frees.
+ */
+struct BigIntStats {
+    std::array<BigIntCounter, static_cast<size_t>(BigIntOperation::Count)> counters{};
+    int64_t currentBytes = 0;
+    int64_t peakBytes = 0;
+
+    /**
+     * @brief Returns the counters of an operation.
+     *
+     * @param operation The operation.
+     * @return A reference to its counters.
+     */
+    BigIntCounter& operator[](BigIntOperation operation) {
+        return counters[static_cast<size_t>(operation)];
+    }
+
+    /**
+     * @brief Returns the counters of an operation.
+     *
+     * @param operation The operation.
+     * @return A reference to its counters.
+     */
+    const BigIntCounter& operator[](BigIntOperation operation) const {
+        return counters[static_cast<size_t>(operation)];
+    }
+
+    /**
+     * @brief Returns the name of an operation, as used by the dumps.
+     *
+     * @param operation The operation.
+     * @return The name, such as "multiply.karatsuba".
+     */
+    static const char* name(BigIntOperation operation) {
+        static const char* const names[] = {"add", "subtract", "multiply", "multiply.schoolbook",
+                                            "multiply.karatsuba", "divide", "divide.small", "parse", "print",
+                                            "binary_split", "product_tree", "other"};
+        static_assert(std::size(names) == static_cast<size_t>(BigIntOperation::Count), "One name per operation");
+        return names[static_cast<size_t>(operation)];
+    }
+
+    /**
+     * @brief Dumps the counters as a JSON object, with one object per operation.
+     *
+     * @return The JSON text.
+     */
+    std::string toJson() const {
+        std::ostringstream output;
+        output << "{\"current_bytes\": " << currentBytes << ", \"peak_bytes\": " << peakBytes << ", \"operations\": [";
+        for (size_t i = 0; i < counters.size(); ++i) {
+            const BigIntCounter& counter = counters[i];
+            output << (i == 0 ? "\n" : ",\n") << "  {\"operation\": \"" << name(static_cast<BigIntOperation>(i))
+                   << "\", \"calls\": " << counter.calls << ", \"digit_operations\": " << counter.digitOperations
+                   << ", \"bytes\": " << counter.bytes << ", \"nanoseconds\": " << counter.nanoseconds
+                   << ", \"allocations\": " << counter.allocations << ", \"deallocations\": " << counter.deallocations
+                   << ", \"allocated_bytes\": " << counter.allocatedBytes << ", \"peak_bytes\": " << counter.peakBytes
+                   << "}";
+        }
+        output << "\n]}\n";
+        return output.str();
+    }
+
+    /**
+     * @brief Dumps the counters of the operations that were called as a table.
+     *
+     * @param output The output stream.
+     * @param stats The counters.
+     * @return A reference to the output stream.
+     */
+    friend std::ostream& operator<<(std::ostream& output, const BigIntStats& stats) {
+        std::ios::fmtflags flags = output.flags();
+        std::streamsize precision = output.precision();
+        output << std::left << std::setw(20) << "operation" << std::right << std::setw(12) << "calls"
+               << std::setw(16) << "digit ops" << std::setw(16) << "bytes" << std::setw(14) << "time (ms)"
+               << std::setw(12) << "allocs" << std::setw(16) << "peak bytes" << "\n";
+        output << std::fixed << std::setprecision(3);
+        for (size_t i = 0; i < stats.counters.size(); ++i) {
+            const BigIntCounter& counter = stats.counters[i];
+            if (counter.calls != 0 || counter.allocations != 0) {
+                output << std::left << std::setw(20) << name(static_cast<BigIntOperation>(i)) << std::right
+                       << std::setw(12) << counter.calls << std::setw(16) << counter.digitOperations << std::setw(16)
+                       << counter.bytes << std::setw(14) << static_cast<double>(counter.nanoseconds) / 1e6
+                       << std::setw(12) << counter.allocations << std::setw(16) << counter.peakBytes << "\n";
+            }
+        }
+        output << "thread: " << stats.currentBytes << " bytes held, " << stats.peakBytes << " bytes at peak\n";
+        output.flags(flags);
+        output.precision(precision);
+        return output;
+    }
+};
+
+/**
+ * @brief The allocator of the digits with BIGINT_TRACK_ALLOCATIONS.
+ *
+ * Forwards to std::allocator and reports every allocation and deallocation to the counters
+ * of the calling thread. A vector that grows allocates a new buffer and frees the old one,
+ * so a reallocation is counted as one allocation and one deallocation.
+ */
+template <typename T>
+struct BigIntAllocator {
+    using value_type = T;
+
+    BigIntAllocator() = default;
+
+    template <typename U>
+    BigIntAllocator(const BigIntAllocator<U>&) {}
+
+    T* allocate(size_t count);
+    void deallocate(T* pointer, size_t count);
+
+    template <typename U>
+    bool operator==(const BigIntAllocator<U>&) const {
+        return true;
+    }
+};
+
+/**
+ * @brief A read-only view of an integer whose digits are stored elsewhere, such as in a BigIntArray.
+ *
+ * The digits are little-endian decimal digits, as in BigInt. High zero digits, such as the
+ * padding of a fixed-width buffer, and the sign of zero are ignored. The view does not own the digits, which must outlive it. Addition,
+ * subtraction, multiplication, comparisons, printing and hashing accept views, and a BigInt
+ * converts to its view, so a value in a borrowed buffer is never copied to be read.
+ */
+struct BigIntView {
+    std::span<const int64_t> digits;
+    bool isNegative = false;
+
+    /**
+     * @brief The single digit of zero, which an empty view stands for.
+     */
+    static constexpr int64_t zeroDigit = 0;
+
+    /**
+     * @brief Returns this view in the form of BigInt, without copying any digit.
+     *
+     * High zero digits, such as the padding of a fixed-width buffer, are left out of the span,
+     * an empty or all-zero span becomes the single digit of zero, and zero is made non-negative.
+     * Every operation on views reads its operands through it, so a default-constructed view is zero.
+     *
+     * @return The view with no leading zeros, at least one digit and a non-negative zero.
+     */
+    BigIntView normalized() const {
+        size_t size = digits.size();
+        while (size > 0 && digits[size - 1] == 0) {
+            --size;
+        }
+        if (size == 0) {
+            return {std::span<const int64_t>(&zeroDigit, 1), false};
+        }
+        return {digits.first(size), isNegative};
+    }
+};
+
+class BigInt;
+
+BigInt operator+(BigIntView a, BigIntView b);
+BigInt operator-(BigIntView a, BigIntView b);
+BigInt operator*(BigIntView a, BigIntView b);
+bool operator==(BigIntView a, BigIntView b);
+std::strong_ordering operator<=>(BigIntView a, BigIntView b);
+std::ostream& operator<<(std::ostream& output, BigIntView value);
+
+/**
+ * @brief Hashes the digits and the sign of a view.
+ *
+ * The digits are read four at a time, 32 bytes per step, into four independent lanes with
+ * the round of xxHash64, so the lanes run in parallel. The lanes are merged, the leftover
+ * digits, the length and the sign are mixed in, and a final avalanche spreads every input
+ * bit over the result. Equal values always have equal hashes, whether they are held by a
+ * BigInt or by a view.
+ */
+template <>
+struct std::hash<BigIntView> {
+    size_t operator()(BigIntView value) const noexcept {
+        value = value.normalized();
+        constexpr uint64_t prime1 = 0x9E3779B185EBCA87ULL;
+        constexpr uint64_t prime2 = 0xC2B2AE3D27D4EB4FULL;
+        constexpr uint64_t prime3 = 0x165667B19E3779F9ULL;
+        constexpr uint64_t prime4 = 0x85EBCA77C2B2AE63ULL;
+        auto round = [](uint64_t lane, int64_t digit) {
+            return std::rotl(lane + static_cast<uint64_t>(digit) * prime2, 31) * prime1;
+        };
+        const int64_t* digits = value.digits.data();
+        size_t size = value.digits.size();
+        std::array<uint64_t, 4> lanes = {prime1 + prime2, prime2, 0, 0 - prime1};
+        size_t i = 0;
+        for (; i + 4 <= size; i += 4) {
+            for (size_t lane = 0; lane < 4; ++lane) {
+                lanes[lane] = round(lanes[lane], digits[i + lane]);
+            }
+        }
+        uint64_t h = std::rotl(lanes[0], 1) + std::rotl(lanes[1], 7) + std::rotl(lanes[2], 12) + std::rotl(lanes[3], 18);
+        for (uint64_t lane : lanes) {
+            h = (h ^ round(0, static_cast<int64_t>(lane))) * prime1 + prime4;
+        }
+        for (; i < size; ++i) {
+            h = std::rotl(h ^ round(0, digits[i]), 27) * prime1 + prime4;
+        }
+        h ^= static_cast<uint64_t>(size) * prime3 + (value.isNegative ? prime4 : 0);
+        h ^= h >> 33;
+        h *= prime2;
+        h ^= h >> 29;
+        h *= prime3;
+        h ^= h >> 32;
+        return static_cast<size_t>(h);
+    }
+};
 
 /**
  * @class BigInt
@@ -15,12 +332,30 @@
  */
 class BigInt {
 private:
+    template <typename>
+    friend struct BigIntAllocator;
+    friend class BigIntArray;
+    friend BigInt operator+(BigIntView a, BigIntView b);
+    friend BigInt operator*(BigIntView a, BigIntView b);
+    friend bool operator==(BigIntView a, BigIntView b);
+    friend std::strong_ordering operator<=>(BigIntView a, BigIntView b);
+    friend std::ostream& operator<<(std::ostream& output, BigIntView value);
+
+    /**
+     * @brief The storage of the digits, with a counting allocator when BIGINT_TRACK_ALLOCATIONS is defined.
+     */
+#ifdef BIGINT_TRACK_ALLOCATIONS
+    using Digits = std::vector<int64_t, BigIntAllocator<int64_t>>;
+#else
+    using Digits = std::vector<int64_t>;
+#endif
+
     /**
      * @brief To store the number of digits.
      * 
      * Each element is a digit from 0 to 9.
      */
-    std::vector<int64_t> number;
+    Digits number;
 
     /**
      * @brief Determines if a number is negative.
@@ -43,6 +378,15 @@ private:
         }
     }
 
+    /**
+     * @brief Checks if the number is zero.
+     *
+     * @return Returns true if the number is zero, false otherwise.
+     */
+    bool isZero() const {
+        return number.size() == 1 && number[0] == 0;
+    }
+
 public:
     /**
      * @brief Default constructor, initializes the number to 0.
@@ -73,6 +417,7 @@ public:
      * @throws std::invalid_argument if the string is invalid.
      */
     BigInt(const std::string& str) {
+        BIGINT_SCOPE(BigIntOperation::Parse, str.size(), str.size() * sizeof(int64_t));
         if (str.empty()) {
             throw std::invalid_argument("It is empty");
         }
@@ -98,6 +443,59 @@ public:
         }
     }
 
+    /**
+     * @brief A constructor that converts a floating-point number to a BigInt.
+     *
+     * The value is truncated toward zero, then the digits are built from the mantissa and
+     * the binary exponent, without going through text. The mantissa is read 32 bits at a
+     * time, so types with more than 64 mantissa bits, such as a quad long double, also work.
+     *
+     * @param value The floating-point number, such as a double or a long double.
+     * @throws std::invalid_argument if the value is infinite or NaN.
+     */
+    template <std::floating_point Float>
+    explicit BigInt(Float value);
+
+    /**
+     * @brief A constructor that copies the digits and the sign of a view.
+     *
+     * @param value The view, with digits in the form of BigInt.
+     */
+    explicit BigInt(BigIntView value) : number(value.digits.begin(), value.digits.end()), isNegative(value.isNegative) {
+        if (number.empty()) {
+            number.push_back(0);
+        }
+        removeLeadingZero();
+    }
+
+    /**
+     * @brief Returns a view of the digits and the sign of this BigInt.
+     *
+     * @return The view, valid until this BigInt changes or is destroyed.
+     */
+    BigIntView view() const& {
+        return {number, isNegative};
+    }
+
+    /**
+     * @brief Deleted, since the view of a temporary BigInt would outlive its digits.
+     */
+    BigIntView view() const&& = delete;
+
+    /**
+     * @brief Converts this BigInt to its view, so it mixes with views in every read-only operation.
+     *
+     * @return The view, valid until this BigInt changes or is destroyed.
+     */
+    operator BigIntView() const& {
+        return view();
+    }
+
+    /**
+     * @brief Deleted, since the view of a temporary BigInt would outlive its digits.
+     */
+    operator BigIntView() const&& = delete;
+
     /**
      * @brief Adds two BigInts numbers.
      * 
@@ -105,19 +503,7 @@ public:
      * @return The sum of the two BigInts.
      */
     BigInt operator+(const BigInt& other) const {
-        if (isNegative == other.isNegative) {
-            BigInt sum = absoluteAdd(*this, other);
-            sum.isNegative = isNegative;
-            return sum;
-        }
-        if (absoluteComparison(*this, other) >= 0) {
-            BigInt difference = absoluteSubtract(*this, other);
-            difference.isNegative = isNegative;
-            return difference;
-        }
-        BigInt diff = absoluteSubtract(other, *this);
-        diff.isNegative = other.isNegative;
-        return diff;
+        return view() + other.view();
     }
 
     /**
@@ -138,7 +524,7 @@ public:
      * @return The answer of the subtraction.
      */
     BigInt operator-(const BigInt& other) const {
-        return *this + (-other);
+        return view() - other.view();
     }
 
     /**
@@ -154,33 +540,16 @@ public:
 
     /**
      * @brief Multiplies this BigInt by another BigInt.
+     *
+     * The digit products are accumulated without carries, then the carries are propagated in
+     * one pass at the end. When the shorter operand is below karatsubaThreshold() digits, the
+     * schoolbook method runs inline; otherwise multiplyDigits switches to Karatsuba.
      * 
      * @param other The other BigInt to multiply first BigInt by.
      * @return The product of these two BigInts.
      */
     BigInt operator*(const BigInt& other) const {
-        BigInt answer;
-        answer.number.resize(number.size() + other.number.size(), 0);
-        answer.isNegative = (isNegative != other.isNegative);
-
-        for (size_t i = 0; i < number.size(); ++i) {
-            int64_t carry = 0;
-            for (size_t j = 0; j < other.number.size() || carry; ++j) {
-                int64_t multiplicand = (int64_t)number[i];
-                int64_t multiplier;
-                if (j < other.number.size()) {
-                    multiplier = other.number[j];
-                } else {
-                    multiplier = 0;
-                }
-                int64_t product = multiplicand * multiplier; 
-                int64_t current = answer.number[i + j] + product + carry;
-                answer.number[i + j] = current % 10;
-                carry = current / (int64_t)10;
-            }
-        }
-        answer.removeLeadingZero();
-        return answer;
+        return view() * other.view();
     }
 
     /**
@@ -195,89 +564,120 @@ public:
     }
 
     /**
-     * @brief Negates this BigInt.
-     * 
-     * @return The negated BigInt.
+     * @brief Divides this BigInt by another BigInt.
+     *
+     * The quotient is truncated toward zero, the same as the built-in integer division.
+     * Divisors of up to smallDivisorDigits digits take the one-pass divideSmall.
+     *
+     * @param other The divisor.
+     * @return The quotient of the division.
+     * @throws std::invalid_argument if the divisor is zero.
      */
-    BigInt operator-() const {
-        BigInt answer = *this;
-        if (number[0] == 0 && number.size() == 1) {
-            answer.isNegative = false;
+    BigInt operator/(const BigInt& other) const {
+        if (other.isZero()) {
+            throw std::invalid_argument("Division by zero");
+        }
+        BigInt quotient;
+        if (other.number.size() <= smallDivisorDigits) {
+            quotient = divideSmall(*this, static_cast<int64_t>(toUnsigned(other)));
         } else {
-            answer.isNegative = !isNegative;
+            quotient = absoluteDivide(*this, other).first;
         }
-        return answer;
+        quotient.isNegative = (isNegative != other.isNegative);
+        quotient.removeLeadingZero();
+        return quotient;
     }
 
     /**
-     * @brief Compares this BigInt to another BigInt to determine equality.
-     * 
-     * @param other The other BigInt to compare.
-     * @return Returns true if the two BigInt are equal, false otherwise.
+     * @brief Divides this BigInt by another BigInt.
+     *
+     * @param other The divisor.
+     * @return A reference to this BigInt.
+     * @throws std::invalid_argument if the divisor is zero.
      */
-    bool operator==(const BigInt& other) const {
-        bool sameSign = (isNegative == other.isNegative);
-        bool sameNumber = (number == other.number);
-        return sameNumber && sameSign;
+    BigInt& operator/=(const BigInt& other) {
+        *this = *this / other;
+        return *this;
     }
 
     /**
-     * @brief Compares this BigInt to another BigInt to determine if they are unequal.
-     * 
-     * @param other The other BigInt to compare.
-     * @return Returns true if the two BigInt are unequal, false otherwise.
+     * @brief Computes the remainder of dividing this BigInt by another BigInt.
+     *
+     * The remainder has the same sign as this BigInt, the same as the built-in % operator.
+     * Divisors of up to smallDivisorDigits digits take the one-pass remainderSmall.
+     *
+     * @param other The divisor.
+     * @return The remainder of the division.
+     * @throws std::invalid_argument if the divisor is zero.
      */
-    bool operator!=(const BigInt& other) const {
-        bool sameSign = (isNegative == other.isNegative);
-        bool sameNumber = (number == other.number);
-        return !(sameNumber && sameSign);
+    BigInt operator%(const BigInt& other) const {
+        if (other.isZero()) {
+            throw std::invalid_argument("Division by zero");
+        }
+        BigInt remainder;
+        if (other.number.size() <= smallDivisorDigits) {
+            int64_t divisor = static_cast<int64_t>(toUnsigned(other));
+            remainder = fromUnsigned(static_cast<uint64_t>(remainderSmall(*this, divisor)));
+        } else {
+            remainder = absoluteDivide(*this, other).second;
+        }
+        remainder.isNegative = isNegative;
+        remainder.removeLeadingZero();
+        return remainder;
     }
 
-
     /**
-     * @brief Checks if this BigInt is less than another BigInt.
-     * 
-     * @param other The other BigInt to compare.
-     * @return Returns true if this BigInt is less than another BigInt, false otherwise.
+     * @brief Replaces this BigInt by the remainder of dividing it by another BigInt.
+     *
+     * @param other The divisor.
+     * @return A reference to this BigInt.
+     * @throws std::invalid_argument if the divisor is zero.
      */
-    bool operator<(const BigInt& other) const {
-        if (isNegative != other.isNegative) {
-            return isNegative;
-        }
-        if (isNegative) {
-            return absoluteComparison(*this, other) > 0;
-        }
-        return absoluteComparison(*this, other) < 0;
+    BigInt& operator%=(const BigInt& other) {
+        *this = *this % other;
+        return *this;
     }
 
     /**
-     * @brief Checks if this BigInt is greater than another BigInt.
+     * @brief Negates this BigInt.
      * 
-     * @param other The other BigInt to compare.
-     * @return Returns true if this BigInt is greater than the other BigInt, false otherwise.
+     * @return The negated BigInt.
      */
-    bool operator>(const BigInt& other) const {
-        return other < *this;
+    BigInt operator-() const {
+        BigInt answer = *this;
+        if (number[0] == 0 && number.size() == 1) {
+            answer.isNegative = false;
+        } else {
+            answer.isNegative = !isNegative;
+        }
+        return answer;
     }
 
     /**
-     * @brief Checks if this BigInt is less than or equal to another BigInt.
-     * 
+     * @brief Compares this BigInt to another BigInt to determine equality.
+     *
+     * The signs and the lengths are compared first, so only numbers of the same sign and length
+     * compare their digits. The compiler also derives operator!= from this operator.
+     *
      * @param other The other BigInt to compare.
-     * @return Return true if this BigInt is less than or equal to the other BigInt, false otherwise.
+     * @return Returns true if the two BigInt are equal, false otherwise.
      */
-    bool operator<=(const BigInt& other) const {
-        return !(other < *this);
+    bool operator==(const BigInt& other) const {
+        return view() == other.view();
     }
 
     /**
-     * @brief Checks if this BigInt is greater than or equal to another BigInt.
-     * 
+     * @brief Orders this BigInt and another BigInt.
+     *
+     * The sign decides first, then the number of digits, both in constant time, and only numbers
+     * of the same sign and length compare their digits from the most significant one with
+     * absoluteComparison. The compiler derives operator<, >, <= and >= from this operator.
+     *
      * @param other The other BigInt to compare.
-     * @return Return true if this BigInt is greater than or equal to the other BigInt, false otherwise.
+     * @return Returns the ordering of this BigInt relative to the other BigInt.
      */
-    bool operator>=(const BigInt& other) const {
-        return !(*this < other);
+    std::strong_ordering operator<=>(const BigInt& other) const {
+        return view() <=> other.view();
     }
 
     /**
@@ -288,13 +688,7 @@ public:
      * @return A reference to the output stream.
      */
     friend std::ostream &operator<<(std::ostream& output, const BigInt& integer) {
-        if (integer.isNegative) {
-            output << '-';
-        }
-        for (int64_t i = static_cast<int64_t>(integer.number.size()) - 1; i >= 0; --i) {
-            output << integer.number[static_cast<std::size_t>(i)];
-        }
-        return output;
+        return output << integer.view();
     }
 
     /**
@@ -339,91 +733,1500 @@ public:
         return temp;
     }
 
-
-private:
-
     /**
-     * @brief Computes the absolute sum of two BigInts.
-     * 
+     * @brief Computes the greatest common divisor of two BigInts and its Bezout coefficients.
+     *
+     * Only the cofactor of a is carried through the Euclidean loop, the cofactor of b
+     * is recovered with one division at the end.
+     *
      * @param a The first BigInt.
      * @param b The second BigInt.
-     * @return The absolute sum of these two BigInts.
+     * @return The tuple (g, s, t) with g = gcd(a, b) >= 0 and a * s + b * t == g.
      */
-    static BigInt absoluteAdd(const BigInt& a, const BigInt& b) {
-        BigInt sumAbs;
-        sumAbs.number.clear();
-        int64_t carry = 0;
-        size_t maxLength = std::max(a.number.size(), b.number.size());
-        for (size_t i = 0; i < maxLength || carry; ++i) {
-            int64_t sum = carry;
-            if (i < a.number.size()) {
-                sum += a.number[i];
-            }
-            if (i < b.number.size()) { 
-                sum += b.number[i];
-            }
-            sumAbs.number.push_back(sum % 10);
-            carry = sum / 10;
-        }
-        return sumAbs;
-    }
+    static std::tuple<BigInt, BigInt, BigInt> gcdext(const BigInt& a, const BigInt& b);
 
     /**
-     * @brief Computes the absolute difference of two BigInts.
-     * 
-     * @param a The first BigInt.
-     * @param b The second BigInt.
-     * @return The absolute difference of these two BigInts.
+     * @brief Computes the inverse of a BigInt modulo another BigInt.
+     *
+     * @param a The BigInt to invert.
+     * @param m The modulus, must be positive.
+     * @return The unique x in [0, m) with a * x == 1 (mod m).
+     * @throws std::invalid_argument if m is not positive or a is not invertible modulo m.
      */
-    static BigInt absoluteSubtract(const BigInt& a, const BigInt& b) {
-        BigInt diffAbs;
-        diffAbs.number.clear();
-        int64_t borrow = 0;
-        for (size_t i = 0; i < a.number.size(); ++i) {
-            int64_t temp = 0;
-            if (i < b.number.size()) {
-                temp = b.number[i];
-            }
-            int64_t diff = a.number[i] - temp - borrow;
-            if (diff < 0) {
-                diff += 10;
-                borrow = 1;
-            } else {
-                borrow = 0;
-            }
-            diffAbs.number.push_back(diff);
-        }
-        diffAbs.removeLeadingZero();
-        return diffAbs;
-    }
+    static BigInt invert(const BigInt& a, const BigInt& m);
 
     /**
-     * @brief Compares the absolute values of two BigInts.
-     * 
-     * @param a The first BigInt.
-     * @param b The second BigInt.
-     * @return Return 1 if a > b, return -1 if a < b, and return 0 if a == b.
+     * @brief Inverts many BigInts modulo the same BigInt.
+     *
+     * Uses Montgomery's trick, so only one modular inversion is done for the whole batch,
+     * the rest are three multiplications per value.
+     *
+     * @param values The BigInts to invert.
+     * @param m The modulus, must be positive.
+     * @return The inverses of values, in the same order.
+     * @throws std::invalid_argument if m is not positive or any value is not invertible modulo m.
      */
-    static int64_t absoluteComparison(const BigInt& a, const BigInt& b) {
-        if (a.number.size() != b.number.size()) {
-            if (a.number.size() > b.number.size()) {
-                return 1;
-            } else {
-                return -1;
-            }
-        }
+    static std::vector<BigInt> batchInvert(const std::vector<BigInt>& values, const BigInt& m);
 
-        for (int64_t i = static_cast<int64_t>(a.number.size()) - 1; i >= 0; --i) {
-            if (a.number[static_cast<size_t>(i)] != b.number[static_cast<size_t>(i)]) {
-                if (a.number[static_cast<size_t>(i)] > b.number[static_cast<size_t>(i)]) {
-                    return 1;
-                } else {
-                    return -1;
-                }
-            }
-        }
-        return 0;
-    }
-};
+    /**
+     * @brief Raises a BigInt to a power modulo another BigInt.
+     *
+     * The exponent is read one decimal digit at a time, so each step raises the running
+     * result to the 10th power and multiplies by a precomputed power of the base. Every
+     * product is reduced with a Barrett reciprocal of m, computed once per call.
+     *
+     * @param base The base.
+     * @param exponent The exponent, must not be negative.
+     * @param m The modulus, must be positive.
+     * @return The value of base^exponent modulo m in [0, m).
+     * @throws std::invalid_argument if the exponent is negative or m is not positive.
+     */
+    static BigInt powmod(const BigInt& base, const BigInt& exponent, const BigInt& m);
+
+    /**
+     * @brief Computes the integer square root of a BigInt.
+     *
+     * Uses Newton's iteration starting from a power of ten above the root.
+     *
+     * @param n The BigInt, must not be negative.
+     * @return The largest BigInt whose square is less than or equal to n.
+     * @throws std::invalid_argument if n is negative.
+     */
+    static BigInt sqrt(const BigInt& n);
+
+    /**
+     * @brief Checks if this BigInt is a probable prime.
+     *
+     * Runs trial division by the small primes first, then the Baillie-PSW test: a strong
+     * Miller-Rabin test to base 2 followed by a strong Lucas test with Selfridge's parameters.
+     * No composite number is known to pass Baillie-PSW.
+     *
+     * @param rounds The number of additional Miller-Rabin rounds, using the odd primes as bases.
+     * @return Returns true if this BigInt is probably prime, false if it is certainly not prime.
+     */
+    bool isProbablePrime(size_t rounds = 0) const;
+
+    /**
+     * @brief Finds the smallest probable prime greater than this BigInt.
+     *
+     * Sieves a window of odd candidates against all the small primes below 2^16. The residue
+     * of the window start is computed once per prime, then every multiple in the window is
+     * crossed out by stepping, and the next window reuses the residues shifted by the window
+     * length. Only the survivors go through the Baillie-PSW test.
+     *
+     * @param threads How many survivors are tested at the same time, 1 tests them one by one.
+     * @return The next probable prime.
+     */
+    BigInt nextPrime(size_t threads = 1) const;
+
+    /**
+     * @brief Computes the factorial n!.
+     *
+     * Counts the exponent of every prime p <= n with Legendre's formula, then builds the
+     * product of prime powers from the highest exponent bit down: square the running result
+     * and multiply by the balanced product of the primes whose exponent has that bit set.
+     *
+     * @param n The integer.
+     * @return The value of n!.
+     */
+    static BigInt factorial(uint64_t n);
+
+    /**
+     * @brief Computes the double factorial n!! = n * (n - 2) * (n - 4) * ...
+     *
+     * For even n = 2k this is 2^k * k!, and for odd n = 2k + 1 it is n! / (2^k * k!),
+     * so the prime exponents come from Legendre's formula without any division.
+     *
+     * @param n The integer.
+     * @return The value of n!!.
+     */
+    static BigInt doubleFactorial(uint64_t n);
+
+    /**
+     * @brief Computes the primorial n#, the product of all primes less than or equal to n.
+     *
+     * @param n The integer.
+     * @return The value of n#.
+     */
+    static BigInt primorial(uint64_t n);
+
+    /**
+     * @brief Computes the binomial coefficient C(n, k).
+     *
+     * The exponent of each prime p <= n is L(n) - L(k) - L(n - k), where L is Legendre's
+     * formula, so neither the factorials nor a division are ever formed.
+     *
+     * @param n The size of the set.
+     * @param k The size of the subsets.
+     * @return The value of C(n, k), or 0 if k > n.
+     */
+    static BigInt binomial(uint64_t n, uint64_t k);
+
+    /**
+     * @brief Computes the multinomial coefficient (k1 + k2 + ...)! / (k1! * k2! * ...).
+     *
+     * Works the same way as binomial, subtracting the Legendre exponents of every part.
+     *
+     * @param parts The parts k1, k2, ..., their sum must fit in a uint64_t.
+     * @return The multinomial coefficient.
+     */
+    static BigInt multinomial(const std::vector<uint64_t>& parts);
+
+    /**
+     * @brief Computes the Fibonacci number F(n).
+     *
+     * @param n The index.
+     * @return The value of F(n), with F(0) = 0 and F(1) = 1.
+     */
+    static BigInt fibonacci(uint64_t n);
+
+    /**
+     * @brief Computes the Lucas number L(n).
+     *
+     * @param n The index.
+     * @return The value of L(n), with L(0) = 2 and L(1) = 1.
+     */
+    static BigInt lucas(uint64_t n);
+
+    /**
+     * @brief Evaluates a range of a series with binary splitting.
+     *
+     * The leaves are p(n), q(n) and t(n) for every n in [first, last), and two adjacent
+     * ranges are combined as P = P1 * P2, Q = Q1 * Q2 and T = T1 * Q2 + P1 * T2, so the
+     * partial sum of the series over the range is T / Q. The range is split in halves, so
+     * the operands of every multiplication have similar lengths.
+     *
+     * @param first The first index of the range.
+     * @param last One past the last index of the range.
+     * @param pTerm Returns the BigInt p(n).
+     * @param qTerm Returns the BigInt q(n).
+     * @param tTerm Returns the BigInt t(n).
+     * @param parallelDepth How many levels of the recursion tree run their left half with std::async.
+     * @return The tuple (P, Q, T) of the range, or (1, 1, 0) if the range is empty.
+     */
+    template <typename PTerm, typename QTerm, typename TTerm>
+    static std::tuple<BigInt, BigInt, BigInt> binarySplit(uint64_t first, uint64_t last, const PTerm& pTerm,
+                                                          const QTerm& qTerm, const TTerm& tTerm,
+                                                          size_t parallelDepth = 0) {
+        if (first >= last) {
+            return {BigInt(1), BigInt(1), BigInt(0)};
+        }
+        if (last - first == 1) {
+            return {pTerm(first), qTerm(first), tTerm(first)};
+        }
+        BIGINT_SCOPE(BigIntOperation::BinarySplit, last - first, 0);
+        uint64_t middle = first + (last - first) / 2;
+        std::tuple<BigInt, BigInt, BigInt> left;
+        std::tuple<BigInt, BigInt, BigInt> right;
+        if (parallelDepth > 0) {
+            std::future<std::tuple<BigInt, BigInt, BigInt>> leftTask = std::async(std::launch::async, [&] {
+                return binarySplit(first, middle, pTerm, qTerm, tTerm, parallelDepth - 1);
+            });
+            right = binarySplit(middle, last, pTerm, qTerm, tTerm, parallelDepth - 1);
+            left = leftTask.get();
+        } else {
+            left = binarySplit(first, middle, pTerm, qTerm, tTerm, 0);
+            right = binarySplit(middle, last, pTerm, qTerm, tTerm, 0);
+        }
+        auto& [leftP, leftQ, leftT] = left;
+        auto& [rightP, rightQ, rightT] = right;
+        BigInt t = leftT * rightQ + leftP * rightT;
+        return {leftP * rightP, leftQ * rightQ, std::move(t)};
+    }
+
+    /**
+     * @brief Computes pi with the Chudnovsky series and binary splitting.
+     *
+     * Each term of the series adds about 14 digits. A few guard digits are computed and
+     * dropped at the end to absorb the truncation of the square root and the division.
+     *
+     * @param digits The number of digits after the decimal point.
+     * @param parallelDepth Passed to binarySplit.
+     * @return The value of pi * 10^digits rounded down.
+     */
+    static BigInt piDigits(uint64_t digits, size_t parallelDepth = 0);
+
+    /**
+     * @brief A subproduct tree of word-size moduli, built once and reused by crt and multiMod.
+     *
+     * levels[0] holds the moduli, every node of the next level is the product of two adjacent
+     * nodes (an odd node out is carried up alone), and the last level holds the product of
+     * all the moduli. inverses[i] is the inverse of (product / moduli[i]) modulo moduli[i].
+     */
+    struct ModuliTree {
+        std::vector<uint64_t> moduli;
+        std::vector<std::vector<BigInt>> levels;
+        std::vector<uint64_t> inverses;
+    };
+
+    /**
+     * @brief Builds the subproduct tree of pairwise coprime moduli.
+     *
+     * The cofactors product / moduli[i] are reduced top-down: a node passes to each child the
+     * product of everything outside the child, reduced modulo the child, so each level costs
+     * about one multiplication of the full size.
+     *
+     * @param moduli The moduli, each greater than 1 and pairwise coprime.
+     * @return The tree of the moduli.
+     * @throws std::invalid_argument if there are no moduli, or they are not pairwise coprime.
+     */
+    static ModuliTree buildModuliTree(std::span<const uint64_t> moduli);
+
+    /**
+     * @brief Reconstructs a BigInt from its residues modulo word-size moduli.
+     *
+     * @param residues The residues, residues[i] is taken modulo moduli[i].
+     * @param moduli The pairwise coprime moduli.
+     * @return The unique x in [0, product of the moduli) with the given residues.
+     * @throws std::invalid_argument if the sizes differ or the moduli are not valid.
+     */
+    static BigInt crt(std::span<const uint64_t> residues, std::span<const uint64_t> moduli);
+
+    /**
+     * @brief Reconstructs a BigInt from its residues with a prebuilt subproduct tree.
+     *
+     * Every leaf becomes residues[i] * inverses[i] modulo moduli[i], then two adjacent nodes
+     * with values a and b and subproducts A and B are merged into a * B + b * A on the way up.
+     *
+     * @param residues The residues, residues[i] is taken modulo tree.moduli[i].
+     * @param tree The subproduct tree of the moduli.
+     * @return The unique x in [0, product of the moduli) with the given residues.
+     * @throws std::invalid_argument if the number of residues and moduli differ.
+     */
+    static BigInt crt(std::span<const uint64_t> residues, const ModuliTree& tree);
+
+    /**
+     * @brief Reduces a BigInt modulo many word-size moduli.
+     *
+     * @param x The BigInt to reduce.
+     * @param moduli The pairwise coprime moduli.
+     * @return The residues of x, each in [0, moduli[i]).
+     * @throws std::invalid_argument if the moduli are not valid.
+     */
+    static std::vector<uint64_t> multiMod(const BigInt& x, std::span<const uint64_t> moduli);
+
+    /**
+     * @brief Reduces a BigInt modulo many word-size moduli with a prebuilt subproduct tree.
+     *
+     * Walks the remainder tree top-down: x is reduced modulo the root, then each remainder
+     * is reduced modulo the two children of its node, so the operands shrink level by level.
+     *
+     * @param x The BigInt to reduce.
+     * @param tree The subproduct tree of the moduli.
+     * @return The residues of x, each in [0, tree.moduli[i]).
+     */
+    static std::vector<uint64_t> multiMod(const BigInt& x, const ModuliTree& tree);
+
+    /**
+     * @brief Raises a BigInt to a power.
+     *
+     * @param base The base.
+     * @param exponent The exponent.
+     * @return The value of base^exponent, with 0^0 = 1.
+     */
+    static BigInt pow(const BigInt& base, uint64_t exponent);
+
+    /**
+     * @brief Draws a uniformly random BigInt in [0, bound).
+     *
+     * The digits are drawn from the most significant down, the top one in [0, top digit of
+     * bound]. As long as they equal the digits of bound, the next one decides: below the digit of
+     * bound the result is accepted and the remaining digits are cut from 18-digit chunks of the
+     * generator, above it the draw restarts at once. A restart happens at most half of the time
+     * and costs O(1) digits on average.
+     *
+     * @param bound The exclusive upper bound, must be positive.
+     * @param rng A uniform random bit generator, such as std::mt19937_64.
+     * @return The random BigInt.
+     * @throws std::invalid_argument if bound is not positive.
+     */
+    template <std::uniform_random_bit_generator Rng>
+    static BigInt randomBelow(const BigInt& bound, Rng& rng) {
+        if (bound.isNegative || bound.isZero()) {
+            throw std::invalid_argument("Bound must be positive");
+        }
+        const uint64_t chunkSize = 1000000000000000000;
+        std::uniform_int_distribution<uint64_t> chunkDistribution(0, chunkSize - 1);
+        std::uniform_int_distribution<int64_t> topDistribution(0, bound.number.back());
+        std::uniform_int_distribution<int64_t> digitDistribution(0, 9);
+
+        BigInt answer;
+        answer.number.resize(bound.number.size());
+        size_t decided = 0;
+        while (true) {
+            size_t i = answer.number.size() - 1;
+            answer.number[i] = topDistribution(rng);
+            while (answer.number[i] == bound.number[i] && i > 0) {
+                --i;
+                answer.number[i] = digitDistribution(rng);
+            }
+            if (answer.number[i] < bound.number[i]) {
+                decided = i;
+                break;
+            }
+        }
+        uint64_t chunk = 0;
+        for (size_t i = 0; i < decided; ++i) {
+            if (i % 18 == 0) {
+                chunk = chunkDistribution(rng);
+            }
+            answer.number[i] = static_cast<int64_t>(chunk % 10);
+            chunk /= 10;
+        }
+        answer.removeLeadingZero();
+        return answer;
+    }
+
+    /**
+     * @brief Draws a uniformly random BigInt with at most nbits bits.
+     *
+     * The bound 2^nbits is cached per thread, so drawing many values of the same width
+     * builds it only once.
+     *
+     * @param nbits The number of random bits.
+     * @param rng A uniform random bit generator, such as std::mt19937_64.
+     * @return The random BigInt in [0, 2^nbits).
+     */
+    template <std::uniform_random_bit_generator Rng>
+    static BigInt randomBits(uint64_t nbits, Rng& rng) {
+        return randomBelow(powerOfTwo(nbits), rng);
+    }
+
+    /**
+     * @brief Converts this BigInt to the nearest double.
+     *
+     * Up to 19 digits the value fits in a uint64_t and the hardware conversion rounds it.
+     * Longer values are divided by a power of two that leaves 60 to 62 bits in the quotient,
+     * which is then rounded to 53 bits to nearest, ties to even, with the remainder as the
+     * sticky bit. Values of more than 309 digits are always out of range.
+     *
+     * @return The correctly rounded double, or an infinity if the value is out of range.
+     */
+    double toDouble() const;
+
+    /**
+     * @brief Approximates the base 2 logarithm of the absolute value of this BigInt.
+     *
+     * Reads only the top 19 digits, so the cost does not depend on the length.
+     *
+     * @return The logarithm, or minus infinity if this BigInt is zero.
+     */
+    double log2() const;
+
+    /**
+     * @brief Approximates the base 10 logarithm of the absolute value of this BigInt.
+     *
+     * Reads only the top 19 digits, so the cost does not depend on the length.
+     *
+     * @return The logarithm, or minus infinity if this BigInt is zero.
+     */
+    double log10() const;
+
+    /**
+     * @brief Hashes this BigInt from its digits and its sign, with std::hash<BigIntView>.
+     *
+     * @return The hash of this BigInt, the same as the hash of its view.
+     */
+    size_t hash() const {
+        return std::hash<BigIntView>()(view());
+    }
+
+    /**
+     * @brief Sorts BigInts in increasing order with a most significant digit first radix sort.
+     *
+     * Every value is keyed by a sequence of 64-bit words: its sign and length first, so values
+     * are bucketed by sign and length, then its digits from the most significant one, 19 per
+     * word, complemented for negative values. The keys are distributed one byte at a time into
+     * 256 buckets, and a word is only computed once its bucket still holds values that share
+     * all the words before it. Buckets of fewer than 64 values are finished with std::sort.
+     * Only a permutation of the keys moves during the sort; the BigInts are moved once at the end.
+     *
+     * @param values The BigInts to sort, in place.
+     * @param threads How many threads sort the buckets, 1 sorts on the calling thread. A split into
+     * fewer buckets than threads, such as by sign, passes the threads on to its buckets.
+     */
+    static void sort(std::span<BigInt> values, size_t threads = 1);
+
+    /**
+     * @brief Returns the number of digits from which multiplication switches to Karatsuba.
+     *
+     * Starts at BIGINT_KARATSUBA_THRESHOLD and can be changed through the returned reference,
+     * which is how bigint_tune times the candidates. Values below 2 are treated as 2.
+     *
+     * @return A reference to the threshold.
+     */
+    static size_t& karatsubaThreshold() {
+        static size_t threshold = BIGINT_KARATSUBA_THRESHOLD;
+        return threshold;
+    }
+
+    /**
+     * @brief Returns a snapshot of the operation counters of the calling thread.
+     *
+     * The counters are only updated when BIGINT_INSTRUMENT is defined; otherwise they stay at zero
+     * and the operations carry no extra work. Work done by std::async tasks, such as the parallel
+     * binarySplit, is counted in the threads that ran it.
+     *
+     * @return The counters of every operation.
+     */
+    static BigIntStats statistics() {
+#ifdef BIGINT_INSTRUMENT
+        return threadStatistics();
+#else
+        return BigIntStats();
+#endif
+    }
+
+    /**
+     * @brief Resets the operation counters of the calling thread to zero.
+     */
+    static void resetStatistics() {
+#ifdef BIGINT_INSTRUMENT
+        threadStatistics() = BigIntStats();
+#endif
+    }
+
+    /**
+     * @brief Writes the recorded trace events of every thread as Chrome trace JSON.
+     *
+     * With BIGINT_TRACE, every counted operation, including each level of the Karatsuba,
+     * binary splitting and product tree recursions, is recorded when it ends into a buffer
+     * of its thread. The running threads together keep at most BIGINT_TRACE_CAPACITY events,
+     * and the last BIGINT_TRACE_CAPACITY events of the threads that ended are kept too. The output
+     * can be opened in chrome://tracing or Perfetto. Call it while no other thread is
+     * computing, otherwise the newest events of that thread can be missing or mixed.
+     * Without BIGINT_TRACE the trace is empty.
+     *
+     * @param output The output stream, such as a std::ofstream.
+     */
+    static void writeTrace(std::ostream& output) {
+#ifdef BIGINT_TRACE
+        TraceRegistry& registry = traceRegistry();
+        std::lock_guard<std::mutex> lock(registry.mutex);
+        std::vector<TraceEvent> events;
+        for (size_t i = 0; i < registry.finished.size(); ++i) {
+            events.push_back(registry.finished[(registry.finishedOldest + i) % registry.finished.size()]);
+        }
+        for (const TraceBuffer* buffer : registry.live) {
+            for (size_t i = 0; i < buffer->events.size(); ++i) {
+                events.push_back(buffer->events[(buffer->oldest + i) % buffer->events.size()]);
+            }
+        }
+        std::chrono::steady_clock::time_point epoch = std::chrono::steady_clock::time_point::max();
+        for (const TraceEvent& event : events) {
+            epoch = std::min(epoch, event.start);
+        }
+
+        std::ios::fmtflags flags = output.flags();
+        std::streamsize precision = output.precision();
+        output << std::fixed << std::setprecision(3) << "{\"traceEvents\": [";
+        for (size_t i = 0; i < events.size(); ++i) {
+            const TraceEvent& event = events[i];
+            double start = std::chrono::duration<double, std::micro>(event.start - epoch).count();
+            output << (i == 0 ? "\n" : ",\n") << "  {\"name\": \"" << BigIntStats::name(event.operation)
+                   << "\", \"ph\": \"X\", \"pid\": 1, \"tid\": " << event.thread << ", \"ts\": " << start
+                   << ", \"dur\": " << static_cast<double>(event.nanoseconds) / 1e3
+                   << ", \"args\": {\"digit_operations\": " << event.digitOperations << "}}";
+        }
+        output << "\n]}\n";
+        output.flags(flags);
+        output.precision(precision);
+#else
+        output << "{\"traceEvents\": [\n]}\n";
+#endif
+    }
+
+    /**
+     * @brief Drops the recorded trace events of every thread and frees their buffers.
+     *
+     * Call it while no other thread is computing.
+     */
+    static void clearTrace() {
+#ifdef BIGINT_TRACE
+        TraceRegistry& registry = traceRegistry();
+        std::lock_guard<std::mutex> lock(registry.mutex);
+        registry.finished.clear();
+        registry.finishedOldest = 0;
+        for (TraceBuffer* buffer : registry.live) {
+            buffer->events = {};
+            buffer->oldest = 0;
+            registry.available.fetch_add(buffer->granted, std::memory_order_relaxed);
+            buffer->granted = 0;
+        }
+#endif
+    }
+
+
+private:
+
+    /**
+     * @brief Compares the absolute values of two BigInts.
+     * 
+     * @param a The first BigInt.
+     * @param b The second BigInt.
+     * @return Return 1 if a > b, return -1 if a < b, and return 0 if a == b.
+     */
+    static int64_t absoluteComparison(const BigInt& a, const BigInt& b) {
+        return compareMagnitudes(a.number, b.number);
+    }
+
+    /**
+     * @brief Adds the magnitudes of two digit arrays.
+     *
+     * The digits are first summed position by position, a loop without a carry chain that the
+     * compiler vectorizes, then the carries are propagated in a second, branch-free pass.
+     *
+     * @param a The digits of the first operand, without leading zeros.
+     * @param b The digits of the second operand, without leading zeros.
+     * @param out The output, at least max(a.size(), b.size()) + 1 digits, not overlapping a or b.
+     * @return The number of digits of the sum, without leading zeros.
+     */
+    static size_t addMagnitudes(std::span<const int64_t> a, std::span<const int64_t> b, int64_t* out) {
+        if (a.size() < b.size()) {
+            std::swap(a, b);
+        }
+        size_t n = a.size();
+        size_t m = b.size();
+        for (size_t i = 0; i < m; ++i) {
+            out[i] = a[i] + b[i];
+        }
+        std::copy(a.begin() + static_cast<std::ptrdiff_t>(m), a.end(), out + m);
+        int64_t carry = 0;
+        for (size_t i = 0; i < n; ++i) {
+            int64_t digit = out[i] + carry;
+            carry = digit >= 10 ? 1 : 0;
+            out[i] = digit - 10 * carry;
+        }
+        out[n] = carry;
+        return n + static_cast<size_t>(carry);
+    }
+
+    /**
+     * @brief Subtracts the magnitude of a digit array from a larger or equal one.
+     *
+     * @param a The digits of the first operand, without leading zeros, at least b.
+     * @param b The digits of the second operand, without leading zeros.
+     * @param out The output, at least a.size() digits, not overlapping b.
+     * @return The number of digits of the difference, without leading zeros, at least 1.
+     */
+    static size_t subtractMagnitudes(std::span<const int64_t> a, std::span<const int64_t> b, int64_t* out) {
+        size_t n = a.size();
+        size_t m = b.size();
+        int64_t borrow = 0;
+        for (size_t i = 0; i < n; ++i) {
+            int64_t digit = a[i] - (i < m ? b[i] : 0) - borrow;
+            borrow = digit < 0 ? 1 : 0;
+            out[i] = digit + 10 * borrow;
+        }
+        while (n > 1 && out[n - 1] == 0) {
+            --n;
+        }
+        return n;
+    }
+
+    /**
+     * @brief Compares the magnitudes of two digit arrays.
+     *
+     * Digit arrays of different lengths are ordered by length. Otherwise equal blocks of the
+     * most significant digits are skipped with std::equal, which is a vectorized memcmp for
+     * int64_t, so a long common prefix costs one pass at memory speed.
+     *
+     * @param a The digits of the first operand, without leading zeros.
+     * @param b The digits of the second operand, without leading zeros.
+     * @return Return 1 if a > b, return -1 if a < b, and return 0 if a == b.
+     */
+    static int64_t compareMagnitudes(std::span<const int64_t> a, std::span<const int64_t> b) {
+        if (a.size() != b.size()) {
+            return a.size() > b.size() ? 1 : -1;
+        }
+        constexpr size_t block = 32;
+        size_t i = a.size();
+        while (i >= block && std::equal(a.data() + (i - block), a.data() + i, b.data() + (i - block))) {
+            i -= block;
+        }
+        while (i > 0 && a[i - 1] == b[i - 1]) {
+            --i;
+        }
+        if (i == 0) {
+            return 0;
+        }
+        return a[i - 1] > b[i - 1] ? 1 : -1;
+    }
+
+    /**
+     * @brief Multiplies the magnitudes of two digit arrays and propagates the carries.
+     *
+     * When the shorter operand is below karatsubaThreshold() digits, the schoolbook method runs
+     * inline; otherwise multiplyDigits switches to Karatsuba.
+     *
+     * @param a The digits of the first operand.
+     * @param b The digits of the second operand.
+     * @param out The output, a.size() + b.size() zeros, not overlapping a or b.
+     * @return The number of digits of the product, without leading zeros.
+     */
+    static size_t multiplyMagnitudes(std::span<const int64_t> a, std::span<const int64_t> b, int64_t* out) {
+        size_t n = a.size();
+        size_t m = b.size();
+        if (std::min(n, m) < std::max(karatsubaThreshold(), static_cast<size_t>(2))) {
+            multiplySchoolbook(a.data(), n, b.data(), m, out);
+        } else {
+            multiplyDigits(a.data(), n, b.data(), m, out);
+        }
+        int64_t carry = 0;
+        for (size_t i = 0; i < n + m; ++i) {
+            int64_t current = out[i] + carry;
+            out[i] = current % 10;
+            carry = current / 10;
+        }
+        size_t length = n + m;
+        while (length > 1 && out[length - 1] == 0) {
+            --length;
+        }
+        return length;
+    }
+
+    /**
+     * @brief Adds two signed values given as views.
+     *
+     * @param a The first value, not empty.
+     * @param b The second value, not empty.
+     * @param out The output, at least max(a.digits.size(), b.digits.size()) + 1 digits.
+     * @param negative Receives the sign of the sum, false for zero.
+     * @return The number of digits of the sum, without leading zeros.
+     */
+    static size_t addSigned(BigIntView a, BigIntView b, int64_t* out, bool& negative) {
+        if (a.isNegative == b.isNegative) {
+            negative = a.isNegative;
+            return addMagnitudes(a.digits, b.digits, out);
+        }
+        if (compareMagnitudes(a.digits, b.digits) < 0) {
+            std::swap(a, b);
+        }
+        size_t length = subtractMagnitudes(a.digits, b.digits, out);
+        negative = a.isNegative && !(length == 1 && out[0] == 0);
+        return length;
+    }
+
+    /**
+     * @brief Returns the absolute value of this BigInt.
+     *
+     * @return A copy of this BigInt with a non-negative sign.
+     */
+    BigInt absolute() const {
+        BigInt answer = *this;
+        answer.isNegative = false;
+        return answer;
+    }
+
+    /**
+     * @brief Reduces a BigInt modulo a positive BigInt.
+     *
+     * Unlike operator%, the answer is never negative.
+     *
+     * @param a The BigInt to reduce.
+     * @param m The positive modulus.
+     * @return The remainder of a modulo m in [0, m).
+     */
+    static BigInt floorModulo(const BigInt& a, const BigInt& m) {
+        BigInt remainder = a % m;
+        if (remainder.isNegative) {
+            remainder += m;
+        }
+        return remainder;
+    }
+
+    /**
+     * @brief A modulus of k digits with its Barrett reciprocal, defined after the class.
+     */
+    struct BarrettModulus;
+
+    /**
+     * @brief Computes the Barrett reciprocal of a positive modulus with one long division.
+     *
+     * @param m The positive modulus.
+     * @return The modulus with its reciprocal.
+     */
+    static BarrettModulus buildBarrett(const BigInt& m);
+
+    /**
+     * @brief Reduces a BigInt modulo a Barrett modulus.
+     *
+     * For |a| < 10^(2k), the quotient is estimated from the top digits of a times the
+     * reciprocal, so the reduction costs two multiplications and at most two subtractions of
+     * the modulus instead of a long division. Larger values fall back to floorModulo.
+     *
+     * @param a The BigInt to reduce.
+     * @param modulus The modulus with its reciprocal.
+     * @return The remainder of a modulo the modulus in [0, modulus).
+     */
+    static BigInt barrettReduce(const BigInt& a, const BarrettModulus& modulus);
+
+    /**
+     * @brief Drops the lowest decimal digits of a non-negative BigInt.
+     *
+     * @param a The non-negative BigInt.
+     * @param count The number of digits to drop.
+     * @return The value of floor(a / 10^count).
+     */
+    static BigInt shiftDigitsRight(const BigInt& a, size_t count) {
+        if (count >= a.number.size()) {
+            return BigInt();
+        }
+        BigInt answer;
+        answer.number.assign(a.number.begin() + static_cast<std::ptrdiff_t>(count), a.number.end());
+        return answer;
+    }
+
+    /**
+     * @brief Computes the power of a BigInt modulo a Barrett modulus, as powmod does.
+     *
+     * @param base The base.
+     * @param exponent The non-negative exponent.
+     * @param modulus The modulus with its reciprocal.
+     * @return The value of base^exponent modulo the modulus in [0, modulus).
+     */
+    static BigInt powmod(const BigInt& base, const BigInt& exponent, const BarrettModulus& modulus);
+
+    /**
+     * @brief Divides the absolute values of two BigInts with the long division.
+     *
+     * Every quotient digit is estimated from the leading digits of the running remainder
+     * and the divisor, then the divisor times that digit is subtracted in place. The
+     * estimate is never too small and at most one too large, so at most one add-back is needed.
+     *
+     * @param a The dividend.
+     * @param b The divisor, must not be zero.
+     * @return The pair of the absolute quotient and the absolute remainder.
+     */
+    static std::pair<BigInt, BigInt> absoluteDivide(const BigInt& a, const BigInt& b);
+
+    /**
+     * @brief The largest divisor accepted by divideSmall and remainderSmall.
+     *
+     * Keeps the running remainder times 10 plus a digit inside int64_t.
+     */
+    static constexpr int64_t smallDivisorLimit = 100000000000000000;
+
+    /**
+     * @brief The number of digits of the divisors that / and % send to divideSmall and remainderSmall.
+     *
+     * Every number of this many digits is below smallDivisorLimit.
+     */
+    static constexpr size_t smallDivisorDigits = 17;
+
+    /**
+     * @brief Divides the absolute value of a BigInt by a small positive integer.
+     *
+     * Runs one pass from the most significant digit, carrying the remainder in an int64_t.
+     *
+     * @param a The dividend.
+     * @param divisor The divisor, in (0, smallDivisorLimit].
+     * @return The absolute quotient.
+     */
+    static BigInt divideSmall(const BigInt& a, int64_t divisor) {
+        BIGINT_SCOPE(BigIntOperation::DivideSmall, a.number.size(), a.number.size() * sizeof(int64_t));
+        BigInt quotient;
+        quotient.number.assign(a.number.size(), 0);
+        int64_t remainder = 0;
+        for (size_t i = a.number.size(); i > 0; --i) {
+            remainder = remainder * 10 + a.number[i - 1];
+            quotient.number[i - 1] = remainder / divisor;
+            remainder %= divisor;
+        }
+        quotient.removeLeadingZero();
+        return quotient;
+    }
+
+    /**
+     * @brief Computes the absolute value of a BigInt modulo a small positive integer.
+     *
+     * @param a The dividend.
+     * @param divisor The divisor, in (0, smallDivisorLimit].
+     * @return The remainder of |a| divided by divisor.
+     */
+    static int64_t remainderSmall(const BigInt& a, int64_t divisor) {
+        BIGINT_SCOPE(BigIntOperation::DivideSmall, a.number.size(), 0);
+        int64_t remainder = 0;
+        for (size_t i = a.number.size(); i > 0; --i) {
+            remainder = (remainder * 10 + a.number[i - 1]) % divisor;
+        }
+        return remainder;
+    }
+
+    /**
+     * @brief Returns the table of primes below 2^16.
+     *
+     * The table is built once with the sieve of Eratosthenes on first use.
+     *
+     * @return The primes in increasing order.
+     */
+    static const std::vector<int64_t>& smallPrimes();
+
+    /**
+     * @brief Computes the residues of a BigInt modulo the first small primes.
+     *
+     * Consecutive primes are grouped so that their product stays below smallDivisorLimit,
+     * then one remainderSmall pass over the digits serves the whole group.
+     *
+     * @param a The BigInt, its sign is ignored.
+     * @param count How many of the small primes to use.
+     * @return The residues, in the same order as smallPrimes().
+     */
+    static std::vector<int64_t> smallResidues(const BigInt& a, size_t count);
+
+    /**
+     * @brief The number of odd candidates sieved at a time by nextPrime.
+     */
+    static constexpr size_t sieveWindow = 4096;
+
+    /**
+     * @brief Runs the Baillie-PSW test and the additional Miller-Rabin rounds.
+     *
+     * @param n The odd BigInt to test, not divisible by any small prime.
+     * @param rounds The number of additional Miller-Rabin rounds.
+     * @return Returns true if n is probably prime, false otherwise.
+     */
+    static bool passesBailliePSW(const BigInt& n, size_t rounds);
+
+    /**
+     * @brief Writes n - 1 or n + 1 as d * 2^s with d odd.
+     *
+     * @param value The even BigInt to split.
+     * @param d Receives the odd part.
+     * @return The exponent s.
+     */
+    static size_t splitPowerOfTwo(const BigInt& value, BigInt& d);
+
+    /**
+     * @brief Runs one strong Miller-Rabin test.
+     *
+     * @param n The odd BigInt to test, greater than base + 1, with its Barrett reciprocal.
+     * @param base The witness.
+     * @return Returns true if n is a strong probable prime to the base, false otherwise.
+     */
+    static bool millerRabin(const BarrettModulus& n, const BigInt& base);
+
+    /**
+     * @brief Computes the Jacobi symbol (a / n) for a small a.
+     *
+     * Strips the sign and the factors of two of a, then flips the symbol with the
+     * quadratic reciprocity so only small numbers are left.
+     *
+     * @param a The small integer on top.
+     * @param n The odd positive BigInt at the bottom.
+     * @return The Jacobi symbol, -1, 0 or 1.
+     */
+    static int jacobi(int64_t a, const BigInt& n);
+
+    /**
+     * @brief Halves a residue modulo an odd BigInt.
+     *
+     * @param x The residue in [0, n).
+     * @param n The odd modulus.
+     * @return The residue y in [0, n) with 2 * y == x (mod n).
+     */
+    static BigInt halveModulo(const BigInt& x, const BigInt& n);
+
+    /**
+     * @brief Runs the strong Lucas probable prime test with Selfridge's parameters.
+     *
+     * D is the first of 5, -7, 9, -11, ... with (D / n) == -1, P = 1 and Q = (1 - D) / 4.
+     * The Lucas sequences are climbed along the bits of d, where n + 1 = d * 2^s.
+     *
+     * @param n The odd BigInt to test, not divisible by any small prime, with its Barrett reciprocal.
+     * @return Returns true if n is a strong Lucas probable prime, false otherwise.
+     */
+    static bool strongLucas(const BarrettModulus& n);
+
+    /**
+     * @brief Lists the primes less than or equal to n with the sieve of Eratosthenes.
+     *
+     * @param n The upper bound.
+     * @return The primes in increasing order.
+     */
+    static std::vector<uint64_t> primesUpTo(uint64_t n);
+
+    /**
+     * @brief Computes the exponent of a prime in n! with Legendre's formula.
+     *
+     * @param n The integer.
+     * @param p The prime.
+     * @return The sum of n / p^i over i >= 1.
+     */
+    static uint64_t legendreExponent(uint64_t n, uint64_t p);
+
+    /**
+     * @brief Multiplies the BigInts of a range as a balanced binary tree.
+     *
+     * Operands of similar length are multiplied together, which keeps the total work close
+     * to one multiplication of the final size instead of a quadratic chain.
+     *
+     * @param factors The factors.
+     * @param first The first index of the range.
+     * @param last One past the last index of the range.
+     * @return The product of factors[first, last), or 1 if the range is empty.
+     */
+    static BigInt balancedProduct(const std::vector<BigInt>& factors, size_t first, size_t last);
+
+    /**
+     * @brief Computes the product of p^e over primes p and exponents e.
+     *
+     * Walks the exponent bits from the highest one down. At each bit the running result is
+     * squared, then multiplied by the balanced product of the primes whose exponent has the
+     * bit set. The primes are first packed into int64_t words to shorten the product tree.
+     *
+     * @param primes The primes.
+     * @param exponents The exponent of each prime.
+     * @return The product of the prime powers.
+     */
+    static BigInt productOfPrimePowers(const std::vector<uint64_t>& primes, const std::vector<uint64_t>& exponents);
+
+    /**
+     * @brief Computes the pair of the Fibonacci number F(n) and the Lucas number L(n).
+     *
+     * Climbs the bits of n with the fast doubling identities
+     * F(2k) = F(k) * L(k), L(2k) = L(k)^2 - 2 * (-1)^k, and for an odd index
+     * F(2k + 1) = (F(2k) + L(2k)) / 2, L(2k + 1) = (5 * F(2k) + L(2k)) / 2,
+     * so each bit costs one multiplication and one squaring.
+     *
+     * @param n The index.
+     * @return The pair (F(n), L(n)).
+     */
+    static std::pair<BigInt, BigInt> fibonacciLucas(uint64_t n);
+
+    /**
+     * @brief Builds the power of ten 10^k directly from its digits.
+     *
+     * @param k The exponent.
+     * @return The value of 10^k.
+     */
+    static BigInt powerOfTen(size_t k);
+
+    /**
+     * @brief Returns the power of two 2^k, remembering the last one built on this thread.
+     *
+     * @param k The exponent.
+     * @return The value of 2^k, valid until the next call on the same thread.
+     */
+    static const BigInt& powerOfTwo(uint64_t k);
+
+    /**
+     * @brief Converts an unsigned 64-bit integer to a BigInt.
+     *
+     * @param value The unsigned integer, which may not fit in an int64_t.
+     * @return The BigInt with the same value.
+     */
+    static BigInt fromUnsigned(uint64_t value) {
+        BigInt answer;
+        answer.number.clear();
+        do {
+            answer.number.push_back(static_cast<int64_t>(value % 10));
+            value /= 10;
+        } while (value != 0);
+        return answer;
+    }
+
+    /**
+     * @brief Converts the absolute value of a BigInt to an unsigned 64-bit integer.
+     *
+     * @param a The BigInt, its absolute value must be less than 2^64.
+     * @return The absolute value of a.
+     */
+    static uint64_t toUnsigned(const BigInt& a) {
+        uint64_t value = 0;
+        for (size_t i = a.number.size(); i > 0; --i) {
+            value = value * 10 + static_cast<uint64_t>(a.number[i - 1]);
+        }
+        return value;
+    }
+
+    /**
+     * @brief Adds the product of two digit arrays to an output array with the schoolbook method, without carries.
+     *
+     * @param a The first operand, n digits.
+     * @param n The length of a.
+     * @param b The second operand, m digits.
+     * @param m The length of b.
+     * @param out The output, at least n + m digits, the product is added to it.
+     */
+    static void multiplySchoolbook(const int64_t* a, size_t n, const int64_t* b, size_t m, int64_t* out) {
+        BIGINT_SCOPE(BigIntOperation::MultiplySchoolbook, n * m, 0);
+        for (size_t i = 0; i < n; ++i) {
+            for (size_t j = 0; j < m; ++j) {
+                out[i + j] += a[i] * b[j];
+            }
+        }
+    }
+
+    /**
+     * @brief Adds the product of two digit arrays to an output array, without carries.
+     *
+     * Below karatsubaThreshold() digits the shorter operand goes through the schoolbook
+     * method. A much longer operand is cut into pieces the size of the shorter one. Otherwise
+     * both are split at half the longer length into low and high parts, and the three
+     * products low * low, high * high and (low + high) * (low + high) give the whole product.
+     * The digits of the recursive operands can exceed 9, which int64_t easily holds.
+     *
+     * @param a The first operand, n digits.
+     * @param n The length of a.
+     * @param b The second operand, m digits.
+     * @param m The length of b.
+     * @param out The output, at least n + m digits, the product is added to it.
+     */
+    static void multiplyDigits(const int64_t* a, size_t n, const int64_t* b, size_t m, int64_t* out);
+
+    /**
+     * @brief The key of a BigInt during sort: the current word of the value and its position.
+     */
+    struct SortEntry {
+        uint64_t key;
+        size_t index;
+    };
+
+    /**
+     * @brief Returns one word of the radix sort key of a BigInt.
+     *
+     * Word 0 orders by sign and then by length, longer first for negative values. Word k > 0
+     * holds the k-th group of 19 digits from the most significant digit, padded with zeros at
+     * the low end and complemented for negative values.
+     *
+     * @param value The BigInt.
+     * @param word The index of the word, at most the number of digit groups of the value.
+     * @return The word.
+     */
+    static uint64_t sortKey(const BigInt& value, size_t word);
+
+    /**
+     * @brief Sorts the keys of values that share all the words before word and the bits above shift + 8.
+     *
+     * @param values The BigInts being sorted, not moved.
+     * @param entries The keys to sort, holding the word given by word.
+     * @param buffer Scratch space of the same size as entries.
+     * @param word The index of the word in the keys.
+     * @param shift The bit position of the byte to distribute, -8 to move on to the next word.
+     * @param threads How many threads sort the buckets of the next split. With more threads than
+     * buckets, every bucket gets a thread and a share of the threads proportional to its size.
+     */
+    static void radixSort(std::span<BigInt> values, std::span<SortEntry> entries, std::span<SortEntry> buffer,
+                          size_t word, int shift, size_t threads);
+
+
+#ifdef BIGINT_INSTRUMENT
+    /**
+     * @brief Returns the operation counters of the calling thread.
+     *
+     * @return A reference to the counters.
+     */
+    static BigIntStats& threadStatistics() {
+        thread_local BigIntStats stats;
+        return stats;
+    }
+
+#ifdef BIGINT_TRACE
+    /**
+     * @brief One finished operation recorded by the tracing.
+     */
+    struct TraceEvent {
+        BigIntOperation operation;
+        std::chrono::steady_clock::time_point start;
+        uint64_t nanoseconds;
+        uint64_t digitOperations;
+        uint64_t thread;
+    };
+
+    struct TraceBuffer;
+
+    /**
+     * @brief The trace buffers of the running threads and the events of the threads that ended.
+     *
+     * The live buffers together hold at most BIGINT_TRACE_CAPACITY events; available is what
+     * is left of that budget. The events of a thread that ends are moved into finished, a ring
+     * that keeps the last BIGINT_TRACE_CAPACITY of them, and its buffer is freed.
+     */
+    struct TraceRegistry {
+        std::mutex mutex;
+        std::vector<TraceBuffer*> live;
+        std::vector<TraceEvent> finished;
+        size_t finishedOldest = 0;
+        std::atomic<size_t> available{BIGINT_TRACE_CAPACITY};
+        uint64_t threads = 0;
+
+        /**
+         * @brief Keeps an event of a thread that ended, overwriting the oldest one when the ring is full.
+         *
+         * @param event The event.
+         */
+        void keep(const TraceEvent& event) {
+            if (finished.size() < BIGINT_TRACE_CAPACITY) {
+                finished.push_back(event);
+            } else {
+                finished[finishedOldest] = event;
+                finishedOldest = (finishedOldest + 1) % finished.size();
+            }
+        }
+    };
+
+    /**
+     * @brief Returns the registry of the trace buffers.
+     *
+     * @return A reference to the registry.
+     */
+    static TraceRegistry& traceRegistry() {
+        static TraceRegistry registry;
+        return registry;
+    }
+
+    /**
+     * @brief The trace events of one running thread.
+     *
+     * Only its own thread records into it, so recording takes no lock. The buffer starts empty
+     * and grows by taking room from the budget of the registry, at least 256 events at a time,
+     * until it holds as much room as is left, so one busy thread cannot starve the others.
+     * When it cannot grow it becomes a ring over the events it has, and an empty buffer drops
+     * the event. When the thread ends, its events are moved to the registry and its room is
+     * given back.
+     */
+    struct TraceBuffer {
+        std::vector<TraceEvent> events;
+        size_t oldest = 0;
+        size_t granted = 0;
+        uint64_t thread;
+
+        TraceBuffer() {
+            TraceRegistry& registry = traceRegistry();
+            std::lock_guard<std::mutex> lock(registry.mutex);
+            thread = ++registry.threads;
+            registry.live.push_back(this);
+        }
+
+        TraceBuffer(const TraceBuffer&) = delete;
+        TraceBuffer& operator=(const TraceBuffer&) = delete;
+
+        ~TraceBuffer() {
+            TraceRegistry& registry = traceRegistry();
+            std::lock_guard<std::mutex> lock(registry.mutex);
+            for (size_t i = 0; i < events.size(); ++i) {
+                registry.keep(events[(oldest + i) % events.size()]);
+            }
+            std::erase(registry.live, this);
+            registry.available.fetch_add(granted, std::memory_order_relaxed);
+        }
+
+        /**
+         * @brief Records an event, overwriting the oldest one when no more room can be taken.
+         *
+         * @param event The event, whose thread is set here.
+         */
+        void record(TraceEvent event) {
+            event.thread = thread;
+            if (events.size() < granted || (oldest == 0 && grow())) {
+                events.push_back(event);
+            } else if (!events.empty()) {
+                events[oldest] = event;
+                oldest = (oldest + 1) % events.size();
+            }
+        }
+
+        /**
+         * @brief Takes more room from the budget of the registry.
+         *
+         * @return Returns true if some room was taken, false if the buffer already holds as much
+         * room as is left.
+         */
+        bool grow() {
+            std::atomic<size_t>& available = traceRegistry().available;
+            size_t wanted = std::max<size_t>(granted, 256);
+            size_t left = available.load(std::memory_order_relaxed);
+            size_t taken = 0;
+            do {
+                if (left == 0 || granted >= left) {
+                    return false;
+                }
+                taken = std::min(wanted, left);
+            } while (!available.compare_exchange_weak(left, left - taken, std::memory_order_relaxed));
+            granted += taken;
+            events.reserve(granted);
+            return true;
+        }
+    };
+
+    /**
+     * @brief Returns the trace buffer of the calling thread, registering it on the first call.
+     *
+     * @return A reference to the buffer.
+     */
+    static TraceBuffer& threadTrace() {
+        thread_local TraceBuffer buffer;
+        return buffer;
+    }
+#endif
+
+    /**
+     * @brief Counts one call of an operation for as long as it is alive.
+     *
+     * The scopes of a thread form a stack. When a scope ends, its time minus the time of the
+     * scopes nested in it is added to its operation, and its whole time to the enclosing scope.
+     * Allocations are counted for the innermost scope, and the memory high-water mark is
+     * passed on to the enclosing scope, so the peak of an operation includes its nested ones.
+     * With BIGINT_TRACE, every scope is also recorded as a trace event when it ends.
+     */
+    class Scope {
+    public:
+        /**
+         * @brief Starts counting a call.
+         *
+         * @param counted The operation.
+         * @param digitOperations The number of digit steps of the call.
+         * @param bytes The size of the digit buffers the call allocates.
+         */
+        Scope(BigIntOperation counted, uint64_t digitOperations, uint64_t bytes)
+            : operation(counted), parent(current()), start(std::chrono::steady_clock::now()),
+              base(threadStatistics().currentBytes), highest(base), steps(digitOperations) {
+            BigIntCounter& counter = threadStatistics()[operation];
+            ++counter.calls;
+            counter.digitOperations += digitOperations;
+            counter.bytes += bytes;
+            current() = this;
+        }
+
+        Scope(const Scope&) = delete;
+        Scope& operator=(const Scope&) = delete;
+
+        /**
+         * @brief Stops counting the call and adds its time.
+         */
+        ~Scope() {
+            uint64_t elapsed = static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+                std::chrono::steady_clock::now() - start).count());
+            BigIntCounter& counter = threadStatistics()[operation];
+            counter.nanoseconds += elapsed - std::min(elapsed, nested);
+            counter.peakBytes = std::max(counter.peakBytes, static_cast<uint64_t>(std::max<int64_t>(highest - base, 0)));
+            if (parent != nullptr) {
+                parent->nested += elapsed;
+                parent->highest = std::max(parent->highest, highest);
+            }
+            current() = parent;
+#ifdef BIGINT_TRACE
+            threadTrace().record({operation, start, elapsed, steps, 0});
+#endif
+        }
+
+        /**
+         * @brief Counts an allocation of the calling thread.
+         *
+         * @param bytes The size of the allocation.
+         */
+        static void allocated(size_t bytes) {
+            BigIntStats& stats = threadStatistics();
+            Scope* scope = current();
+            BigIntCounter& counter = stats[scope != nullptr ? scope->operation : BigIntOperation::Other];
+            ++counter.allocations;
+            counter.allocatedBytes += bytes;
+            stats.currentBytes += static_cast<int64_t>(bytes);
+            stats.peakBytes = std::max(stats.peakBytes, stats.currentBytes);
+            if (scope != nullptr) {
+                scope->highest = std::max(scope->highest, stats.currentBytes);
+            } else {
+                counter.peakBytes = std::max(counter.peakBytes, bytes);
+            }
+        }
+
+        /**
+         * @brief Counts a deallocation of the calling thread.
+         *
+         * @param bytes The size of the allocation.
+         */
+        static void deallocated(size_t bytes) {
+            BigIntStats& stats = threadStatistics();
+            Scope* scope = current();
+            ++stats[scope != nullptr ? scope->operation : BigIntOperation::Other].deallocations;
+            stats.currentBytes -= static_cast<int64_t>(bytes);
+        }
+
+    private:
+        BigIntOperation operation;
+        Scope* parent;
+        std::chrono::steady_clock::time_point start;
+        uint64_t nested = 0;
+        int64_t base;
+        int64_t highest;
+        uint64_t steps;
+
+        /**
+         * @brief Returns the innermost scope of the calling thread.
+         *
+         * @return A reference to the pointer to it, null outside of any scope.
+         */
+        static Scope*& current() {
+            thread_local Scope* scope = nullptr;
+            return scope;
+        }
+    };
+#endif
+};
+
+/**
+ * @brief A modulus of k digits with its Barrett reciprocal floor(10^(2k) / modulus).
+ */
+struct BigInt::BarrettModulus {
+    BigInt modulus;
+    BigInt reciprocal;
+    size_t digits;
+};
+
+/**
+ * @brief Adds two values given as views.
+ *
+ * @param a The first value.
+ * @param b The second value.
+ * @return The sum.
+ */
+inline BigInt operator+(BigIntView a, BigIntView b) {
+    a = a.normalized();
+    b = b.normalized();
+    size_t longer = std::max(a.digits.size(), b.digits.size());
+    if (a.isNegative == b.isNegative) {
+        BIGINT_SCOPE(BigIntOperation::Add, longer, (longer + 1) * sizeof(int64_t));
+        BigInt sum;
+        sum.number.resize(longer + 1);
+        sum.number.resize(BigInt::addSigned(a, b, sum.number.data(), sum.isNegative));
+        return sum;
+    }
+    BIGINT_SCOPE(BigIntOperation::Subtract, longer, longer * sizeof(int64_t));
+    BigInt difference;
+    difference.number.resize(longer + 1);
+    difference.number.resize(BigInt::addSigned(a, b, difference.number.data(), difference.isNegative));
+    return difference;
+}
+
+/**
+ * @brief Subtracts a value given as a view from another one.
+ *
+ * The sign of b is flipped in the view, so neither value is copied.
+ *
+ * @param a The value to subtract from.
+ * @param b The value to subtract.
+ * @return The difference.
+ */
+inline BigInt operator-(BigIntView a, BigIntView b) {
+    b = b.normalized();
+    if (!(b.digits.size() == 1 && b.digits[0] == 0)) {
+        b.isNegative = !b.isNegative;
+    }
+    return a + b;
+}
+
+/**
+ * @brief Multiplies two values given as views.
+ *
+ * @param a The first value.
+ * @param b The second value.
+ * @return The product.
+ */
+inline BigInt operator*(BigIntView a, BigIntView b) {
+    a = a.normalized();
+    b = b.normalized();
+    BIGINT_SCOPE(BigIntOperation::Multiply, a.digits.size() + b.digits.size(),
+                 (a.digits.size() + b.digits.size()) * sizeof(int64_t));
+    BigInt answer;
+    answer.number.assign(a.digits.size() + b.digits.size(), 0);
+    answer.number.resize(BigInt::multiplyMagnitudes(a.digits, b.digits, answer.number.data()));
+    answer.isNegative = a.isNegative != b.isNegative && !answer.isZero();
+    return answer;
+}
+
+/**
+ * @brief Compares two values given as views for equality.
+ *
+ * The signs and the lengths are compared before any digit.
+ *
+ * @param a The first value.
+ * @param b The second value.
+ * @return Returns true if the two values are equal, false otherwise.
+ */
+inline bool operator==(BigIntView a, BigIntView b) {
+    a = a.normalized();
+    b = b.normalized();
+    return a.isNegative == b.isNegative && a.digits.size() == b.digits.size() &&
+           BigInt::compareMagnitudes(a.digits, b.digits) == 0;
+}
+
+/**
+ * @brief Orders two values given as views.
+ *
+ * The sign decides first, then the number of digits, both in constant time, and only values
+ * of the same sign and length compare their digits with compareMagnitudes.
+ *
+ * @param a The first value.
+ * @param b The second value.
+ * @return Returns the ordering of a relative to b.
+ */
+inline std::strong_ordering operator<=>(BigIntView a, BigIntView b) {
+    a = a.normalized();
+    b = b.normalized();
+    if (a.isNegative != b.isNegative) {
+        return a.isNegative ? std::strong_ordering::less : std::strong_ordering::greater;
+    }
+    int64_t magnitude = a.isNegative ? BigInt::compareMagnitudes(b.digits, a.digits)
+                                     : BigInt::compareMagnitudes(a.digits, b.digits);
+    return magnitude <=> 0;
+}
+
+/**
+ * @brief Outputs a value given as a view to an output stream.
+ *
+ * @param output The output stream.
+ * @param value The value to be output.
+ * @return A reference to the output stream.
+ */
+inline std::ostream& operator<<(std::ostream& output, BigIntView value) {
+    value = value.normalized();
+    BIGINT_SCOPE(BigIntOperation::Print, value.digits.size(), 0);
+    if (value.isNegative) {
+        output << '-';
+    }
+    for (size_t i = value.digits.size(); i > 0; --i) {
+        output << value.digits[i - 1];
+    }
+    return output;
+}
+
+/**
+ * @brief Hashes BigInt with BigInt::hash, so BigInt can key std::unordered_map and std::unordered_set.
+ */
+template <>
+struct std::hash<BigInt> {
+    size_t operator()(const BigInt& value) const noexcept {
+        return value.hash();
+    }
+};
+
+/**
+ * @brief Allocates memory for some digits and counts it with BIGINT_TRACK_ALLOCATIONS.
+ *
+ * @param count The number of elements.
+ * @return The allocated memory.
+ */
+template <typename T>
+T* BigIntAllocator<T>::allocate(size_t count) {
+#ifdef BIGINT_TRACK_ALLOCATIONS
+    BigInt::Scope::allocated(count * sizeof(T));
+#endif
+    return std::allocator<T>().allocate(count);
+}
+
+/**
+ * @brief Frees memory allocated by allocate and counts it with BIGINT_TRACK_ALLOCATIONS.
+ *
+ * @param pointer The memory.
+ * @param count The number of elements.
+ */
+template <typename T>
+void BigIntAllocator<T>::deallocate(T* pointer, size_t count) {
+#ifdef BIGINT_TRACK_ALLOCATIONS
+    BigInt::Scope::deallocated(count * sizeof(T));
+#endif
+    std::allocator<T>().deallocate(pointer, count);
+}
 
 #endif
@@ -0,0 +1,280 @@
+#ifndef BIGINT_ARRAY_HPP
+#define BIGINT_ARRAY_HPP
+
+#include <algorithm>
+#include <functional>
+#include <span>
+#include <stdexcept>
+#include <vector>
+
+#include "bigint.hpp"
+
+/**
+ * @class BigIntArray
+ * @brief A sequence of BigInts that keeps all their digits in one contiguous pool.
+ *
+ * A std::vector<BigInt> gives every value its own heap block. A BigIntArray stores the digits
+ * of all its values back to back in one vector, with an index of where each value starts and
+ * of its sign, so a pass over the array walks memory in order and appending a value does not
+ * allocate once the pool has grown. The values are read as BigIntView, without copying.
+ */
+class BigIntArray {
+private:
+    /**
+     * @brief The digits of all the values, back to back, each in the form of BigInt.
+     */
+    BigInt::Digits pool;
+
+    /**
+     * @brief The position in pool of the first digit of each value, followed by the size of pool.
+     */
+    std::vector<size_t> offsets;
+
+    /**
+     * @brief The sign of each value, true if it is negative.
+     */
+    std::vector<bool> negative;
+
+    /**
+     * @brief Applies an operation to the values of two arrays at the same positions.
+     *
+     * The digits of each result are written straight into the pool of the answer, which is
+     * sized once for all of them and trimmed at the end.
+     *
+     * @param other The other array, of the same size.
+     * @param bound Returns an upper bound of the number of digits of one result.
+     * @param operation Writes one result to its output and returns its number of digits.
+     * @return The array of the results.
+     * @throws std::invalid_argument if the arrays have different sizes.
+     */
+    template <typename Bound, typename Operation>
+    BigIntArray elementwise(const BigIntArray& other, const Bound& bound, const Operation& operation) const {
+        if (size() != other.size()) {
+            throw std::invalid_argument("Arrays of different sizes");
+        }
+        size_t total = 0;
+        for (size_t i = 0; i < size(); ++i) {
+            total += bound((*this)[i], other[i]);
+        }
+        BigIntArray answer;
+        answer.pool.assign(total, 0);
+        answer.offsets.reserve(size() + 1);
+        answer.negative.reserve(size());
+        size_t used = 0;
+        for (size_t i = 0; i < size(); ++i) {
+            bool sign = false;
+            size_t written = operation((*this)[i], other[i], answer.pool.data() + used, sign);
+            used += written;
+            answer.offsets.push_back(used);
+            answer.negative.push_back(sign);
+        }
+        answer.pool.resize(used);
+        return answer;
+    }
+
+public:
+    /**
+     * @brief Default constructor, an empty array.
+     */
+    BigIntArray() : offsets{0} {}
+
+    /**
+     * @brief A constructor that copies a sequence of BigInts.
+     *
+     * @param values The BigInts, in order.
+     */
+    explicit BigIntArray(std::span<const BigInt> values) : BigIntArray() {
+        size_t digits = 0;
+        for (const BigInt& value : values) {
+            digits += value.number.size();
+        }
+        reserve(values.size(), digits);
+        for (const BigInt& value : values) {
+            push_back(value);
+        }
+    }
+
+    /**
+     * @brief Returns the number of values.
+     *
+     * @return The number of values.
+     */
+    size_t size() const {
+        return negative.size();
+    }
+
+    /**
+     * @brief Checks if the array has no values.
+     *
+     * @return Returns true if the array is empty, false otherwise.
+     */
+    bool empty() const {
+        return negative.empty();
+    }
+
+    /**
+     * @brief Returns the number of digits of all the values together.
+     *
+     * @return The size of the digit pool.
+     */
+    size_t digitCount() const {
+        return pool.size();
+    }
+
+    /**
+     * @brief Reserves room so that appending does not reallocate.
+     *
+     * @param values The number of values to make room for.
+     * @param digits The number of digits of all of them together.
+     */
+    void reserve(size_t values, size_t digits) {
+        pool.reserve(digits);
+        offsets.reserve(values + 1);
+        negative.reserve(values);
+    }
+
+    /**
+     * @brief Removes all the values, keeping the reserved memory.
+     */
+    void clear() {
+        pool.clear();
+        offsets.assign(1, 0);
+        negative.clear();
+    }
+
+    /**
+     * @brief Appends a copy of a value.
+     *
+     * An empty view is stored as zero, so every stored value has at least one digit. A view of
+     * this array is copied first, since growing the pool would move its digits.
+     *
+     * @param value The value, which may be a view of this array.
+     */
+    void push_back(BigIntView value) {
+        value = value.normalized();
+        std::less<const int64_t*> before;
+        if (!before(value.digits.data(), pool.data()) && before(value.digits.data(), pool.data() + pool.size())) {
+            push_back(BigInt(value));
+            return;
+        }
+        pool.insert(pool.end(), value.digits.begin(), value.digits.end());
+        offsets.push_back(pool.size());
+        negative.push_back(value.isNegative);
+    }
+
+    /**
+     * @brief Appends a copy of a BigInt.
+     *
+     * @param value The BigInt.
+     */
+    void push_back(const BigInt& value) {
+        push_back(value.view());
+    }
+
+    /**
+     * @brief Appends copies of all the values of another array.
+     *
+     * @param other The other array, which may be this array.
+     */
+    void append(const BigIntArray& other) {
+        size_t count = other.size();
+        size_t shift = pool.size();
+        size_t digits = other.pool.size();
+        offsets.reserve(offsets.size() + count);
+        negative.reserve(negative.size() + count);
+        for (size_t i = 0; i < count; ++i) {
+            offsets.push_back(shift + other.offsets[i + 1]);
+            negative.push_back(other.negative[i]);
+        }
+        pool.resize(shift + digits);
+        std::copy_n(other.pool.data(), digits, pool.data() + shift);
+    }
+
+    /**
+     * @brief Returns a view of a value, without copying its digits.
+     *
+     * @param index The position of the value, less than size().
+     * @return The view, valid until the array changes or is destroyed.
+     */
+    BigIntView operator[](size_t index) const {
+        return {std::span<const int64_t>(pool.data() + offsets[index], offsets[index + 1] - offsets[index]),
+                negative[index]};
+    }
+
+    /**
+     * @brief Copies the values into BigInts.
+     *
+     * @return The values, in order.
+     */
+    std::vector<BigInt> toVector() const {
+        std::vector<BigInt> values;
+        values.reserve(size());
+        for (size_t i = 0; i < size(); ++i) {
+            values.emplace_back((*this)[i]);
+        }
+        return values;
+    }
+
+    /**
+     * @brief Adds the values of two arrays at the same positions.
+     *
+     * @param other The other array, of the same size.
+     * @return The array of the sums.
+     * @throws std::invalid_argument if the arrays have different sizes.
+     */
+    BigIntArray operator+(const BigIntArray& other) const {
+        BIGINT_SCOPE(BigIntOperation::Add, pool.size() + other.pool.size(), (pool.size() + other.pool.size() + size()) * sizeof(int64_t));
+        return elementwise(other, [](BigIntView a, BigIntView b) {
+            return std::max(a.digits.size(), b.digits.size()) + 1;
+        }, [](BigIntView a, BigIntView b, int64_t* out, bool& sign) {
+            return BigInt::addSigned(a, b, out, sign);
+        });
+    }
+
+    /**
+     * @brief Subtracts the values of another array from the values of this array at the same positions.
+     *
+     * @param other The other array, of the same size.
+     * @return The array of the differences.
+     * @throws std::invalid_argument if the arrays have different sizes.
+     */
+    BigIntArray operator-(const BigIntArray& other) const {
+        BIGINT_SCOPE(BigIntOperation::Subtract, pool.size() + other.pool.size(), (pool.size() + other.pool.size() + size()) * sizeof(int64_t));
+        return elementwise(other, [](BigIntView a, BigIntView b) {
+            return std::max(a.digits.size(), b.digits.size()) + 1;
+        }, [](BigIntView a, BigIntView b, int64_t* out, bool& sign) {
+            b.isNegative = !b.isNegative;
+            return BigInt::addSigned(a, b, out, sign);
+        });
+    }
+
+    /**
+     * @brief Multiplies the values of two arrays at the same positions.
+     *
+     * @param other The other array, of the same size.
+     * @return The array of the products.
+     * @throws std::invalid_argument if the arrays have different sizes.
+     */
+    BigIntArray operator*(const BigIntArray& other) const {
+        BIGINT_SCOPE(BigIntOperation::Multiply, pool.size() + other.pool.size(), (pool.size() + other.pool.size()) * sizeof(int64_t));
+        return elementwise(other, [](BigIntView a, BigIntView b) {
+            return a.digits.size() + b.digits.size();
+        }, [](BigIntView a, BigIntView b, int64_t* out, bool& sign) {
+            size_t length = BigInt::multiplyMagnitudes(a.digits, b.digits, out);
+            sign = a.isNegative != b.isNegative && !(length == 1 && out[0] == 0);
+            return length;
+        });
+    }
+
+    /**
+     * @brief Compares two arrays for equality.
+     *
+     * @param other The other array.
+     * @return Returns true if both arrays hold the same values in the same order, false otherwise.
+     */
+    bool operator==(const BigIntArray& other) const {
+        return offsets == other.offsets && negative == other.negative && pool == other.pool;
+    }
+};
+
+#endif
@@ -0,0 +1,88 @@
+#include <fstream>
+#include <iostream>
+#include <limits>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "bench_common.hpp"
+#include "bigint.hpp"
+
+/**
+ * @brief Writes the measured thresholds as a CMake script that CMakeLists.txt includes.
+ *
+ * @param path The path of the script.
+ * @param karatsuba The measured Karatsuba threshold.
+ * @return Returns true if the file was written, false otherwise.
+ */
+bool writeTuning(const std::string& path, size_t karatsuba) {
+    std::ofstream file(path);
+    if (!file) {
+        return false;
+    }
+    file << "# Generated by bigint_tune for the host it ran on. Empty this file to go back to the defaults.\n"
+         << "set(BIGINT_TUNED_KARATSUBA_THRESHOLD " << karatsuba << ")\n";
+    return static_cast<bool>(file);
+}
+
+/**
+ * @brief The main function of the threshold tuner.
+ *
+ * For every candidate Karatsuba threshold, times square-ish multiplications at sizes around
+ * the candidates. Each time is divided by the best time at the same size, and the candidate
+ * with the smallest sum of these ratios wins, so no single size dominates the choice.
+ *
+ * @param argc The number of arguments.
+ * @param argv The arguments: [output script, default bigint_tuning.cmake] [minimum time per measurement in seconds].
+ * @return Returns 0 on success, 1 if the script could not be written.
+ */
+int main(int argc, char* argv[]) {
+    std::string output = argc > 1 ? argv[1] : "bigint_tuning.cmake";
+    double minTime = argc > 2 ? std::stod(argv[2]) : 0.05;
+
+    std::vector<size_t> candidates = {8, 12, 16, 24, 32, 48, 64, 96, 128, 192};
+    std::vector<size_t> sizes = {50, 100, 200, 400, 800, 1600};
+    std::mt19937_64 rng(62);
+
+    std::vector<std::vector<double>> times(candidates.size(), std::vector<double>(sizes.size()));
+    for (size_t j = 0; j < sizes.size(); ++j) {
+        BigInt a(randomDigits(sizes[j], rng));
+        BigInt b(randomDigits(sizes[j] - sizes[j] / 8, rng));
+        for (size_t i = 0; i < candidates.size(); ++i) {
+            BigInt::karatsubaThreshold() = candidates[i];
+            times[i][j] = timeCall([&a, &b] { benchSink = benchSink + ((a * b) == a ? 0 : 1); }, minTime);
+        }
+    }
+
+    std::cout << "threshold";
+    for (size_t size : sizes) {
+        std::cout << ',' << size;
+    }
+    std::cout << ",score\n";
+    size_t best = 0;
+    double bestScore = std::numeric_limits<double>::infinity();
+    for (size_t i = 0; i < candidates.size(); ++i) {
+        double score = 0;
+        std::cout << candidates[i];
+        for (size_t j = 0; j < sizes.size(); ++j) {
+            double fastest = std::numeric_limits<double>::infinity();
+            for (size_t k = 0; k < candidates.size(); ++k) {
+                fastest = std::min(fastest, times[k][j]);
+            }
+            score += times[i][j] / fastest;
+            std::cout << ',' << times[i][j];
+        }
+        std::cout << ',' << score << '\n';
+        if (score < bestScore) {
+            bestScore = score;
+            best = i;
+        }
+    }
+
+    if (!writeTuning(output, candidates[best])) {
+        std::cerr << "Cannot write " << output << "\n";
+        return 1;
+    }
+    std::cout << "Karatsuba threshold " << candidates[best] << " written to " << output << "\n";
+    return 0;
+}
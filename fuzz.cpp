@@ -0,0 +1,472 @@
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <cstdlib>
+#include <filesystem>
+#include <fstream>
+#include <functional>
+#include <iostream>
+#include <map>
+#include <random>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include "bigint.hpp"
+
+/**
+ * @brief One fuzz input: an operation and its two operands in decimal.
+ *
+ * Inputs are stored as one line of text, "multiply 123 -456", which is also the format of
+ * the libFuzzer inputs and of the saved regressions.
+ */
+struct FuzzCase {
+    std::string operation;
+    std::string a;
+    std::string b;
+};
+
+/**
+ * @brief The operations checked by the harness.
+ */
+const std::vector<std::string> fuzzOperations = {"add", "multiply", "divide", "convert"};
+
+/**
+ * @brief Reports a failed property and stops, so libFuzzer keeps the input as a crash.
+ *
+ * @param input The failing input.
+ * @param property The property that does not hold.
+ */
+[[noreturn]] void fail(const FuzzCase& input, const std::string& property) {
+    std::cerr << "FAILED " << property << "\n" << input.operation << " " << input.a << " " << input.b << "\n";
+    std::abort();
+}
+
+/**
+ * @brief Returns the canonical decimal form of a BigInt.
+ *
+ * @param value The BigInt.
+ * @return Its decimal digits, with a '-' if it is negative.
+ */
+std::string decimal(const BigInt& value) {
+    std::ostringstream output;
+    output << value;
+    return output.str();
+}
+
+/**
+ * @brief Reads a fuzz input from one line of text.
+ *
+ * @param text The line.
+ * @param input Receives the input.
+ * @return Returns true if the line has a known operation and two valid integers, false otherwise.
+ */
+bool parseCase(const std::string& text, FuzzCase& input) {
+    std::istringstream line(text);
+    if (!(line >> input.operation >> input.a >> input.b)) {
+        return false;
+    }
+    if (std::find(fuzzOperations.begin(), fuzzOperations.end(), input.operation) == fuzzOperations.end()) {
+        return false;
+    }
+    for (const std::string* operand : {&input.a, &input.b}) {
+        size_t first = operand->starts_with('-') ? 1 : 0;
+        if (operand->size() == first || operand->find_first_not_of("0123456789", first) != std::string::npos) {
+            return false;
+        }
+    }
+    return true;
+}
+
+/**
+ * @brief Checks that every multiplication tier gives the same product.
+ *
+ * The product is computed with Karatsuba disabled, then with thresholds at 2, around the
+ * lengths of the operands, and at the default, where the recursion and the splitting of
+ * unbalanced operands take different paths.
+ *
+ * @param input The input.
+ */
+void checkMultiply(const FuzzCase& input) {
+    BigInt a(input.a);
+    BigInt b(input.b);
+    size_t saved = BigInt::karatsubaThreshold();
+    BigInt::karatsubaThreshold() = SIZE_MAX;
+    BigInt schoolbook = a * b;
+    size_t shorter = std::min(input.a.size(), input.b.size());
+    for (size_t threshold : std::vector<size_t>{2, 3, shorter / 2 + 1, shorter, shorter + 1, saved}) {
+        BigInt::karatsubaThreshold() = threshold;
+        if (a * b != schoolbook || b * a != schoolbook) {
+            BigInt::karatsubaThreshold() = saved;
+            fail(input, "Karatsuba with threshold " + std::to_string(threshold) + " == schoolbook");
+        }
+    }
+    BigInt::karatsubaThreshold() = saved;
+    if (b != BigInt(0) && schoolbook / b != a) {
+        fail(input, "(a * b) / b == a");
+    }
+}
+
+/**
+ * @brief Checks the quotient and the remainder of a division.
+ *
+ * Besides q * b + r == a and the bounds of r, the same division is repeated with both
+ * operands scaled by 10^18, which sends a divisor of up to 17 digits through the long
+ * division instead of the one-pass small division, so both tiers are compared.
+ *
+ * @param input The input.
+ */
+void checkDivide(const FuzzCase& input) {
+    BigInt a(input.a);
+    BigInt b(input.b);
+    if (b == BigInt(0)) {
+        return;
+    }
+    BigInt q = a / b;
+    BigInt r = a % b;
+    if (q * b + r != a) {
+        fail(input, "q * b + r == a");
+    }
+    BigInt absoluteR = r < BigInt(0) ? -r : r;
+    BigInt absoluteB = b < BigInt(0) ? -b : b;
+    if (absoluteR >= absoluteB) {
+        fail(input, "|r| < |b|");
+    }
+    if (r != BigInt(0) && (r < BigInt(0)) != (a < BigInt(0))) {
+        fail(input, "r has the sign of a");
+    }
+    BigInt scale = BigInt::pow(BigInt(10), 18);
+    if ((a * scale) / (b * scale) != q) {
+        fail(input, "(a * 10^18) / (b * 10^18) == a / b");
+    }
+}
+
+/**
+ * @brief Checks addition and subtraction against each other.
+ *
+ * @param input The input.
+ */
+void checkAdd(const FuzzCase& input) {
+    BigInt a(input.a);
+    BigInt b(input.b);
+    BigInt sum = a + b;
+    if (sum != b + a) {
+        fail(input, "a + b == b + a");
+    }
+    if (sum - b != a || sum - a != b) {
+        fail(input, "(a + b) - b == a");
+    }
+    if (a - b != -(b - a)) {
+        fail(input, "a - b == -(b - a)");
+    }
+}
+
+/**
+ * @brief Checks the conversions: decimal round trip and correctly rounded toDouble.
+ *
+ * @param input The input.
+ */
+void checkConvert(const FuzzCase& input) {
+    BigInt a(input.a);
+    std::string text = decimal(a);
+    std::string digits = input.a.substr(input.a.starts_with('-') ? 1 : 0);
+    size_t leading = std::min(digits.find_first_not_of('0'), digits.size() - 1);
+    std::string canonical = digits.substr(leading);
+    if (input.a.starts_with('-') && canonical != "0") {
+        canonical = "-" + canonical;
+    }
+    if (text != canonical) {
+        fail(input, "printing gives the canonical decimal form");
+    }
+    if (BigInt(text) != a) {
+        fail(input, "BigInt(print(a)) == a");
+    }
+    if (a.toDouble() != std::strtod(text.c_str(), nullptr)) {
+        fail(input, "toDouble() is correctly rounded");
+    }
+}
+
+/**
+ * @brief Runs the checks of an input.
+ *
+ * @param input The input.
+ */
+void checkCase(const FuzzCase& input) {
+    if (input.operation == "add") {
+        checkAdd(input);
+    } else if (input.operation == "multiply") {
+        checkMultiply(input);
+    } else if (input.operation == "divide") {
+        checkDivide(input);
+    } else {
+        checkConvert(input);
+    }
+}
+
+#ifdef BIGINT_LIBFUZZER
+
+/**
+ * @brief The entry point of libFuzzer: one line of text in the FuzzCase format.
+ *
+ * @param data The input bytes.
+ * @param size The number of bytes.
+ * @return Returns 0.
+ */
+extern "C" int LLVMFuzzerTestOneInput(const uint8_t* data, size_t size) {
+    FuzzCase input;
+    if (size <= 20000 && parseCase(std::string(reinterpret_cast<const char*>(data), size), input)) {
+        checkCase(input);
+    }
+    return 0;
+}
+
+#else
+
+/**
+ * @brief The options of the standalone harness, read from the command line.
+ */
+struct FuzzOptions {
+    uint64_t iterations = 20000;
+    uint64_t seed = 70;
+    size_t maxDigits = 2000;
+    double slowFactor = 20;
+    bool failSlow = true;
+    std::string corpus = "fuzz_regressions";
+    std::string save = "fuzz_regressions";
+};
+
+/**
+ * @brief Builds an operand of the given length, either random or of an adversarial shape.
+ *
+ * The shapes are all nines, a power of ten, a power of ten minus one written as a long run of
+ * nines with a small low part, long runs of zeros, and a repeated digit pattern; they stress
+ * the carries, the borrows and the quotient digit estimate of the division.
+ *
+ * @param digits The number of digits.
+ * @param rng The random generator.
+ * @return The operand in decimal.
+ */
+std::string fuzzOperand(size_t digits, std::mt19937_64& rng) {
+    std::uniform_int_distribution<int> digit(0, 9);
+    std::string str(digits, '0');
+    switch (rng() % 7) {
+    case 0:
+        std::fill(str.begin(), str.end(), '9');
+        break;
+    case 1:
+        str[0] = '1';
+        break;
+    case 2:
+        std::fill(str.begin(), str.end(), '9');
+        str.back() = static_cast<char>('0' + digit(rng));
+        break;
+    case 3:
+        for (size_t i = 0; i < digits; i += 1 + rng() % 32) {
+            str[i] = static_cast<char>('0' + digit(rng));
+        }
+        break;
+    case 4:
+        for (size_t i = 0; i < digits; ++i) {
+            str[i] = "9081726354"[i % (1 + rng() % 10)];
+        }
+        break;
+    default:
+        for (char& c : str) {
+            c = static_cast<char>('0' + digit(rng));
+        }
+        break;
+    }
+    if (rng() % 8 == 0) {
+        str = std::string(rng() % 3, '0') + str;
+    }
+    return rng() % 2 == 0 ? str : "-" + str;
+}
+
+/**
+ * @brief Picks an operand length, often just around a threshold of the algorithms.
+ *
+ * @param options The options.
+ * @param rng The random generator.
+ * @return The number of digits.
+ */
+size_t fuzzLength(const FuzzOptions& options, std::mt19937_64& rng) {
+    size_t threshold = BigInt::karatsubaThreshold();
+    std::vector<size_t> edges = {1, 2, 16, 17, 18, 19, threshold - 1, threshold, threshold + 1,
+                                 2 * threshold - 1, 2 * threshold, 2 * threshold + 1, 4 * threshold + 3};
+    if (rng() % 2 == 0) {
+        return std::clamp<size_t>(edges[rng() % edges.size()], 1, options.maxDigits);
+    }
+    return 1 + rng() % options.maxDigits;
+}
+
+/**
+ * @brief Estimates the work of an input, to tell a slow input from a large one.
+ *
+ * @param input The input.
+ * @return The expected cost, in arbitrary units.
+ */
+double expectedCost(const FuzzCase& input) {
+    double n = static_cast<double>(input.a.size());
+    double m = static_cast<double>(input.b.size());
+    if (input.operation == "multiply") {
+        double longer = std::max(n, m);
+        return 8 * std::pow(longer, 1.585) + n * m / 16;
+    }
+    if (input.operation == "divide") {
+        return 4 * (std::max(n - m, 0.0) + 1) * m + std::pow(std::max(n, m), 1.585);
+    }
+    return n + m + 16;
+}
+
+/**
+ * @brief Runs the checks of an input and measures them.
+ *
+ * @param input The input.
+ * @return The time in nanoseconds.
+ */
+double timeCase(const FuzzCase& input) {
+    std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+    checkCase(input);
+    return std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count();
+}
+
+/**
+ * @brief Reads the command line options.
+ *
+ * @param argc The number of arguments.
+ * @param argv The arguments.
+ * @param options Receives the options.
+ * @return Returns true if the options are valid, false otherwise.
+ */
+bool parseOptions(int argc, char* argv[], FuzzOptions& options) {
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+        if (i + 1 >= argc) {
+            return false;
+        }
+        std::string value = argv[++i];
+        if (arg == "--iterations") {
+            options.iterations = std::stoull(value);
+        } else if (arg == "--seed") {
+            options.seed = std::stoull(value);
+        } else if (arg == "--max-digits") {
+            options.maxDigits = std::max<size_t>(std::stoull(value), 1);
+        } else if (arg == "--slow-factor") {
+            options.slowFactor = std::stod(value);
+        } else if (arg == "--fail-slow") {
+            options.failSlow = value != "0";
+        } else if (arg == "--corpus") {
+            options.corpus = value;
+        } else if (arg == "--save") {
+            options.save = value;
+        } else {
+            return false;
+        }
+    }
+    return true;
+}
+
+/**
+ * @brief Checks if an input is slow for its operation.
+ *
+ * An input is slow when it takes more than one millisecond and its time divided by its
+ * expected cost is more than --slow-factor times the median ratio of its operation. It is
+ * only judged once the operation has 64 ratios.
+ *
+ * @param nanoseconds The time of the input.
+ * @param ratio The time of the input divided by its expected cost.
+ * @param history The ratios of the random inputs of the same operation.
+ * @param options The options.
+ * @return How many times the median ratio the input took, or 0 if it is not slow.
+ */
+double slowness(double nanoseconds, double ratio, const std::vector<double>& history, const FuzzOptions& options) {
+    if (history.size() < 64 || nanoseconds <= 1e6) {
+        return 0;
+    }
+    std::vector<double> sorted = history;
+    std::nth_element(sorted.begin(), sorted.begin() + static_cast<std::ptrdiff_t>(sorted.size() / 2), sorted.end());
+    double median = sorted[sorted.size() / 2];
+    return ratio > options.slowFactor * median ? ratio / median : 0;
+}
+
+/**
+ * @brief The main function of the standalone fuzz harness.
+ *
+ * Checks --iterations random inputs, then replays every saved input of --corpus. Every input
+ * is timed and its time divided by its expected cost. A random input that is slow for its
+ * operation, by the ratios of the random inputs before it, is written to --save as a
+ * regression; a replayed input is judged against the ratios of all the random inputs, so an
+ * input that was saved for being slow fails until the slowness is fixed. With --fail-slow 0
+ * the slow inputs are only reported, since their times depend on the load of the host. A
+ * failed check prints the input and aborts.
+ *
+ * @param argc The number of arguments.
+ * @param argv The arguments: --iterations N, --seed S, --max-digits D, --slow-factor F, --fail-slow 0|1,
+ * --corpus dir, --save dir.
+ * @return Returns 0 when every check passed and no input failed for being slow, 1 for invalid
+ * options, and 2 if a new slow input was saved or a replayed input is still slow, unless
+ * --fail-slow is 0.
+ */
+int main(int argc, char* argv[]) {
+    FuzzOptions options;
+    if (!parseOptions(argc, argv, options)) {
+        std::cerr << "Usage: fuzz [--iterations N] [--seed S] [--max-digits D] [--slow-factor F] "
+                     "[--fail-slow 0|1] [--corpus dir] [--save dir]\n";
+        return 1;
+    }
+
+    std::vector<FuzzCase> corpus;
+    if (std::filesystem::is_directory(options.corpus)) {
+        for (const std::filesystem::directory_entry& entry : std::filesystem::directory_iterator(options.corpus)) {
+            std::ifstream file(entry.path());
+            std::string line;
+            FuzzCase input;
+            if (std::getline(file, line) && parseCase(line, input)) {
+                corpus.push_back(input);
+            }
+        }
+    }
+
+    std::mt19937_64 rng(options.seed);
+    std::map<std::string, std::vector<double>> ratios;
+    size_t saved = 0;
+    for (uint64_t i = 0; i < options.iterations; ++i) {
+        FuzzCase input;
+        input.operation = fuzzOperations[rng() % fuzzOperations.size()];
+        input.a = fuzzOperand(fuzzLength(options, rng), rng);
+        input.b = fuzzOperand(fuzzLength(options, rng), rng);
+        if (input.operation == "divide" && rng() % 2 == 0) {
+            std::swap(input.a, input.b);
+        }
+
+        double nanoseconds = timeCase(input);
+        double ratio = nanoseconds / expectedCost(input);
+        std::vector<double>& history = ratios[input.operation];
+        if (double times = slowness(nanoseconds, ratio, history, options); times > 0) {
+            std::filesystem::create_directories(options.save);
+            std::string line = input.operation + " " + input.a + " " + input.b;
+            std::filesystem::path path = std::filesystem::path(options.save) /
+                                         (input.operation + "-" + std::to_string(std::hash<std::string>()(line)) + ".txt");
+            std::ofstream(path) << line << "\n";
+            std::cout << "slow input (" << times << "x the median cost ratio) saved to " << path.string() << "\n";
+            ++saved;
+        }
+        history.push_back(ratio);
+    }
+
+    size_t stillSlow = 0;
+    for (const FuzzCase& input : corpus) {
+        double nanoseconds = timeCase(input);
+        if (double times = slowness(nanoseconds, nanoseconds / expectedCost(input), ratios[input.operation], options); times > 0) {
+            std::cout << "saved input still slow (" << times << "x the median cost ratio): " << input.operation << " "
+                      << input.a.substr(0, 40) << (input.a.size() > 40 ? "..." : "") << " "
+                      << input.b.substr(0, 40) << (input.b.size() > 40 ? "..." : "") << "\n";
+            ++stillSlow;
+        }
+    }
+
+    std::cout << "Checked " << options.iterations << " random and " << corpus.size() << " saved inputs, "
+              << saved << " slow input(s) saved, " << stillSlow << " saved input(s) still slow\n";
+    return options.failSlow && (saved > 0 || stillSlow > 0) ? 2 : 0;
+}
+#endif
@@ -0,0 +1,302 @@
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <fstream>
+#include <functional>
+#include <iostream>
+#include <map>
+#include <random>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include "bench_common.hpp"
+#include "bigint.hpp"
+
+/**
+ * @brief The timing of one workload.
+ *
+ * median and deviation are the median and the median absolute deviation of the samples, in
+ * nanoseconds per call. Every sample is also divided by the time of the calibration loop run
+ * right around it; ratio and ratioDeviation are the median and the median absolute deviation of
+ * these ratios, which do not depend on the speed of the host.
+ */
+struct WorkloadTiming {
+    double median;
+    double deviation;
+    double ratio;
+    double ratioDeviation;
+};
+
+/**
+ * @brief One fixed workload of the regression harness.
+ */
+struct Workload {
+    std::string name;
+    std::function<void()> call;
+};
+
+/**
+ * @brief Lists the fixed workloads: multiply, add, parse and print at several sizes.
+ *
+ * The operands come from a fixed seed, so every run measures the same work.
+ *
+ * @return The workloads.
+ */
+std::vector<Workload> workloads() {
+    std::mt19937_64 rng(63);
+    std::vector<Workload> list;
+    for (size_t digits : std::vector<size_t>{100, 1000, 10000}) {
+        std::string size = std::to_string(digits);
+        BigInt a(randomDigits(digits, rng));
+        BigInt b(randomDigits(digits, rng));
+        std::string text = randomDigits(digits, rng);
+        list.push_back({"multiply_" + size, [a, b] { benchSink = benchSink + ((a * b) == a ? 0 : 1); }});
+        list.push_back({"add_" + size, [a, b] { benchSink = benchSink + ((a + b) == a ? 0 : 1); }});
+        list.push_back({"parse_" + size, [text] { benchSink = benchSink + (BigInt(text) == BigInt(0) ? 0 : 1); }});
+        list.push_back({"print_" + size, [a] {
+            std::ostringstream output;
+            output << a;
+            benchSink = benchSink + output.str().size();
+        }});
+    }
+    return list;
+}
+
+/**
+ * @brief A fixed loop that does not use BigInt, timed between the samples to measure the speed of the host.
+ */
+void calibrate() {
+    uint64_t state = 63;
+    for (int i = 0; i < 100000; ++i) {
+        state ^= state << 13;
+        state ^= state >> 7;
+        state ^= state << 17;
+    }
+    benchSink = benchSink + static_cast<size_t>(state & 1);
+}
+
+/**
+ * @brief Returns the median of some values.
+ *
+ * @param values The values, reordered by the call.
+ * @return The median.
+ */
+double median(std::vector<double>& values) {
+    std::sort(values.begin(), values.end());
+    size_t middle = values.size() / 2;
+    return values.size() % 2 == 1 ? values[middle] : (values[middle - 1] + values[middle]) / 2;
+}
+
+/**
+ * @brief Returns the median absolute deviation of some values.
+ *
+ * @param values The values.
+ * @param center Their median.
+ * @return The median of the distances to center.
+ */
+double medianDeviation(const std::vector<double>& values, double center) {
+    std::vector<double> deviations;
+    for (double value : values) {
+        deviations.push_back(std::abs(value - center));
+    }
+    return median(deviations);
+}
+
+/**
+ * @brief Times a workload several times and summarizes the samples.
+ *
+ * The number of calls per sample is doubled until one sample takes at least 5 ms,
+ * then the given number of samples is taken. The calibration loop runs right before and right
+ * after every sample, and the sample is divided by the mean of the two, so a change of clock
+ * speed or load during the run scales both sides of the ratio alike.
+ *
+ * @param call The call to time.
+ * @param samples The number of samples.
+ * @return The timing of the workload.
+ */
+WorkloadTiming timeWorkload(const std::function<void()>& call, size_t samples) {
+    using Clock = std::chrono::steady_clock;
+    auto sample = [&call](uint64_t calls) {
+        Clock::time_point start = Clock::now();
+        for (uint64_t i = 0; i < calls; ++i) {
+            call();
+        }
+        return std::chrono::duration<double, std::nano>(Clock::now() - start).count() / static_cast<double>(calls);
+    };
+    uint64_t calls = 1;
+    while (sample(calls) * static_cast<double>(calls) < 5e6) {
+        calls *= 2;
+    }
+
+    auto calibration = [] {
+        Clock::time_point start = Clock::now();
+        calibrate();
+        return std::chrono::duration<double, std::nano>(Clock::now() - start).count();
+    };
+
+    std::vector<double> times;
+    std::vector<double> ratios;
+    for (size_t i = 0; i < samples; ++i) {
+        double before = calibration();
+        double time = sample(calls);
+        double after = calibration();
+        times.push_back(time);
+        ratios.push_back(time / ((before + after) / 2));
+    }
+    double center = median(times);
+    double ratio = median(ratios);
+    return {center, medianDeviation(times, center), ratio, medianDeviation(ratios, ratio)};
+}
+
+/**
+ * @brief Reads a baseline written by writeBaseline.
+ *
+ * Every workload is on its own line as
+ * {"name": "...", "median_ns": ..., "mad_ns": ..., "ratio": ..., "ratio_mad": ...}.
+ *
+ * @param path The path of the baseline.
+ * @param baseline Receives the timings by workload name.
+ * @return Returns true if the file could be read, false otherwise.
+ */
+bool readBaseline(const std::string& path, std::map<std::string, WorkloadTiming>& baseline) {
+    std::ifstream file(path);
+    if (!file) {
+        return false;
+    }
+    std::string line;
+    while (std::getline(file, line)) {
+        size_t name = line.find("\"name\": \"");
+        size_t medianAt = line.find("\"median_ns\": ");
+        size_t deviationAt = line.find("\"mad_ns\": ");
+        size_t ratioAt = line.find("\"ratio\": ");
+        size_t ratioDeviationAt = line.find("\"ratio_mad\": ");
+        if (name == std::string::npos || medianAt == std::string::npos || deviationAt == std::string::npos ||
+            ratioAt == std::string::npos || ratioDeviationAt == std::string::npos) {
+            continue;
+        }
+        name += 9;
+        std::string key = line.substr(name, line.find('"', name) - name);
+        baseline[key] = {std::stod(line.substr(medianAt + 13)), std::stod(line.substr(deviationAt + 10)),
+                         std::stod(line.substr(ratioAt + 9)), std::stod(line.substr(ratioDeviationAt + 13))};
+    }
+    return true;
+}
+
+/**
+ * @brief Writes the timings as a baseline JSON file.
+ *
+ * @param path The path of the baseline.
+ * @param names The workload names, in order.
+ * @param timings The timings by workload name.
+ * @return Returns true if the file was written, false otherwise.
+ */
+bool writeBaseline(const std::string& path, const std::vector<std::string>& names,
+                   const std::map<std::string, WorkloadTiming>& timings) {
+    std::ofstream file(path);
+    if (!file) {
+        return false;
+    }
+    file << "[\n";
+    for (size_t i = 0; i < names.size(); ++i) {
+        const WorkloadTiming& timing = timings.at(names[i]);
+        file << "  {\"name\": \"" << names[i] << "\", \"median_ns\": " << timing.median
+             << ", \"mad_ns\": " << timing.deviation << ", \"ratio\": " << timing.ratio
+             << ", \"ratio_mad\": " << timing.ratioDeviation << "}" << (i + 1 < names.size() ? "," : "") << "\n";
+    }
+    file << "]\n";
+    return static_cast<bool>(file);
+}
+
+/**
+ * @brief The main function of the performance regression harness.
+ *
+ * Runs the fixed workloads and compares the median ratio of every workload to the calibration
+ * loop with the baseline, so a host that is slower or faster than the one that wrote the
+ * baseline, or that changes speed during the run, does not report regressions. A workload
+ * regresses when its ratio is larger than the baseline by more than the threshold and also by
+ * more than three times the combined median absolute deviations, so noisy samples alone do not
+ * fail. A workload that regresses is timed twice more and keeps its best run, and the spread
+ * between the runs is added to the noise, so one cold run or a drifting host cannot fail the
+ * check.
+ *
+ * @param argc The number of arguments.
+ * @param argv The arguments: [--baseline path] [--threshold fraction] [--samples n] [--update].
+ * @return Returns 0 if nothing regressed, 1 on a regression, 2 for invalid options or files.
+ */
+int main(int argc, char* argv[]) {
+    std::string path = "perf_baseline.json";
+    double threshold = 0.10;
+    size_t samples = 15;
+    bool update = false;
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+        if (arg == "--update") {
+            update = true;
+        } else if (arg == "--baseline" && i + 1 < argc) {
+            path = argv[++i];
+        } else if (arg == "--threshold" && i + 1 < argc) {
+            threshold = std::stod(argv[++i]);
+        } else if (arg == "--samples" && i + 1 < argc) {
+            samples = std::stoul(argv[++i]);
+        } else {
+            std::cerr << "Usage: regress [--baseline path] [--threshold fraction] [--samples n] [--update]\n";
+            return 2;
+        }
+    }
+
+    std::map<std::string, WorkloadTiming> baseline;
+    if (!update && !readBaseline(path, baseline)) {
+        std::cerr << "Cannot read " << path << ", run with --update to create it\n";
+        return 2;
+    }
+
+    std::vector<std::string> names;
+    std::map<std::string, WorkloadTiming> timings;
+    int regressions = 0;
+    for (const Workload& workload : workloads()) {
+        WorkloadTiming timing = timeWorkload(workload.call, samples);
+        names.push_back(workload.name);
+        timings[workload.name] = timing;
+        if (update) {
+            std::cout << workload.name << ": " << timing.median << " ns\n";
+            continue;
+        }
+        auto found = baseline.find(workload.name);
+        if (found == baseline.end()) {
+            std::cout << workload.name << ": " << timing.median << " ns, not in the baseline\n";
+            continue;
+        }
+        const WorkloadTiming& before = found->second;
+        double spread = 0;
+        auto regresses = [&](const WorkloadTiming& now) {
+            double noise = 3 * (before.ratioDeviation + now.ratioDeviation) + spread;
+            return now.ratio / before.ratio - 1 > threshold && now.ratio - before.ratio > noise;
+        };
+        int runs = 1;
+        for (; runs < 3 && regresses(timing); ++runs) {
+            WorkloadTiming again = timeWorkload(workload.call, samples);
+            spread = std::max(spread, std::abs(again.ratio - timing.ratio));
+            if (again.ratio < timing.ratio) {
+                timing = again;
+            }
+        }
+        double change = timing.ratio / before.ratio - 1;
+        bool regressed = regresses(timing);
+        regressions += regressed ? 1 : 0;
+        std::cout << workload.name << ": " << timing.median << " ns, baseline " << before.median << " ns, "
+                  << (change >= 0 ? "+" : "") << change * 100 << "% calibrated"
+                  << (runs > 1 ? ", best of " + std::to_string(runs) + " runs" : "") << (regressed ? "  REGRESSION" : "") << "\n";
+    }
+
+    if (update) {
+        if (!writeBaseline(path, names, timings)) {
+            std::cerr << "Cannot write " << path << "\n";
+            return 2;
+        }
+        std::cout << "Baseline written to " << path << "\n";
+        return 0;
+    }
+    std::cout << regressions << " regression(s)\n";
+    return regressions == 0 ? 0 : 1;
+}
@@ -1,8 +1,11 @@
 #include <sstream>
 #include <iostream>
 #include <cassert>
+#include <unordered_map>
+#include <unordered_set>
 
 #include "bigint.hpp"
+#include "bigint_array.hpp"
 
 /**
  * @brief Tests the constructors of the BigInt class.
@@ -55,6 +58,8 @@ void testOperator() {
     
     assert(c * d == BigInt("1465490637660506965476761506497325278166"));
     assert(o * (a + c) == BigInt("0"));
+    assert(c - c == o);
+    assert(c + (-c) == o);
 
     BigInt H("90000000000000000000000000000");
     BigInt h("-90000000000000000000000000000");
@@ -156,6 +161,707 @@ void testOutputOperator() {
     std::cout << "Pass testOutputOperator()\n";
 }
 
+/**
+ * @brief Tests the division and remainder operators of the BigInt class.
+ *
+ * This function verifies truncating division and the sign of the remainder
+ * for operands of different signs, and that dividing by zero throws.
+ */
+void testDivisionOperator() {
+    BigInt a("1059820260501347676949981127582418182524");
+    BigInt b("-48084066885301367633");
+
+    assert(a / b == BigInt("-22040986321506844752"));
+    assert(a % b == BigInt("32803995266209470508"));
+    assert((a / b) * b + a % b == a);
+    assert(-a / b == BigInt("22040986321506844752"));
+    assert(-a % b == BigInt("-32803995266209470508"));
+    assert(b / a == BigInt(0));
+    assert(b % a == b);
+    assert(BigInt(-7) / BigInt(2) == BigInt(-3));
+    assert(BigInt(-7) % BigInt(2) == BigInt(-1));
+
+    try {
+        BigInt invalid = a / BigInt(0);
+        assert(false);
+    } catch (const std::invalid_argument&) {
+    }
+}
+
+/**
+ * @brief Tests the extended GCD and modular inverse functions of the BigInt class.
+ *
+ * This function verifies the Bezout identity returned by gcdext, single and batched
+ * inversion, and that a non-invertible value throws.
+ */
+void testModularInverse() {
+    auto [g, s, t] = BigInt::gcdext(BigInt(240), BigInt(-46));
+    assert(g == BigInt(2));
+    assert(BigInt(240) * s + BigInt(-46) * t == g);
+
+    BigInt m("10000000000000000000000000000000000000027");
+    BigInt x("98765432109876543210");
+    assert(BigInt::invert(x, m) == BigInt("2140700263900473389554770868345212685580"));
+    assert(BigInt::invert(BigInt(123456789), BigInt(1000000007)) == BigInt(18633540));
+
+    std::vector<BigInt> values = {x, BigInt(-5), BigInt(123456789), m - BigInt(1)};
+    std::vector<BigInt> inverses = BigInt::batchInvert(values, m);
+    for (size_t i = 0; i < values.size(); ++i) {
+        assert(inverses[i] == BigInt::invert(values[i], m));
+    }
+
+    try {
+        BigInt invalid = BigInt::invert(BigInt(6), BigInt(9));
+        assert(false);
+    } catch (const std::invalid_argument&) {
+    }
+}
+
+/**
+ * @brief Tests the modular power, square root and primality functions of the BigInt class.
+ *
+ * This function checks powmod and sqrt against known values and runs isProbablePrime on
+ * small numbers, Mersenne primes, Carmichael numbers and a strong pseudoprime to base 2.
+ */
+void testPrimality() {
+    BigInt m("1000000000000000000000000000057");
+    BigInt e("100000000000000000007");
+    assert(BigInt::powmod(BigInt("123456789123456789"), e, m) == BigInt("892344530110434132083913587772"));
+    assert(BigInt::powmod(BigInt(-2), BigInt(3), BigInt(5)) == BigInt(2));
+
+    assert(BigInt::sqrt(BigInt("100000000000000000000000000000000000012345")) == BigInt("316227766016837933199"));
+    assert(BigInt::sqrt(BigInt(1)) == BigInt(1));
+
+    assert(!BigInt(-7).isProbablePrime());
+    assert(!BigInt(1).isProbablePrime());
+    assert(BigInt(2).isProbablePrime());
+    assert(BigInt(997).isProbablePrime());
+    assert(!BigInt(561).isProbablePrime());
+    assert(!BigInt(3215031751).isProbablePrime());
+    assert(BigInt("618970019642690137449562111").isProbablePrime());
+    assert(BigInt("170141183460469231731687303715884105727").isProbablePrime(3));
+    assert(!BigInt("1427247692705959880439315947500961989719490561").isProbablePrime());
+
+    BigInt mersenne = BigInt::pow(BigInt(2), 1279) - BigInt(1);
+    assert(mersenne.isProbablePrime());
+    assert(BigInt::powmod(BigInt(3), mersenne - BigInt(1), mersenne) == BigInt(1));
+    assert(BigInt::powmod(BigInt::pow(BigInt(10), 900) + BigInt(7), BigInt(2), mersenne) ==
+           (BigInt::pow(BigInt(10), 900) + BigInt(7)) * (BigInt::pow(BigInt(10), 900) + BigInt(7)) % mersenne);
+}
+
+/**
+ * @brief Tests the next prime search of the BigInt class.
+ *
+ * This function checks nextPrime below, inside and above the small prime table,
+ * and that testing the survivors on several threads gives the same answer.
+ */
+void testNextPrime() {
+    assert(BigInt(-10).nextPrime() == BigInt(2));
+    assert(BigInt(2).nextPrime() == BigInt(3));
+    assert(BigInt(13).nextPrime() == BigInt(17));
+    assert(BigInt(65521).nextPrime() == BigInt(65537));
+    assert(BigInt("18446744073709551616").nextPrime() == BigInt("18446744073709551629"));
+
+    BigInt start("1000000000000000000000000000000");
+    assert(start.nextPrime() == BigInt("1000000000000000000000000000057"));
+    assert(start.nextPrime(4) == BigInt("1000000000000000000000000000057"));
+}
+
+/**
+ * @brief Tests the factorial, double factorial and primorial functions of the BigInt class.
+ *
+ * This function checks the edge cases 0 and 1 and some known values, and compares
+ * factorial against a plain loop of multiplications.
+ */
+void testFactorial() {
+    assert(BigInt::factorial(0) == BigInt(1));
+    assert(BigInt::factorial(1) == BigInt(1));
+    assert(BigInt::factorial(30) == BigInt("265252859812191058636308480000000"));
+
+    BigInt product(1);
+    for (int64_t i = 2; i <= 300; ++i) {
+        product *= BigInt(i);
+    }
+    assert(BigInt::factorial(300) == product);
+
+    assert(BigInt::doubleFactorial(0) == BigInt(1));
+    assert(BigInt::doubleFactorial(30) == BigInt("42849873690624000"));
+    assert(BigInt::doubleFactorial(31) == BigInt("191898783962510625"));
+
+    assert(BigInt::primorial(1) == BigInt(1));
+    assert(BigInt::primorial(30) == BigInt(6469693230));
+}
+
+/**
+ * @brief Tests the binomial and multinomial coefficients of the BigInt class.
+ *
+ * This function checks known values, the edge cases k = 0, k = n and k > n,
+ * and Pascal's rule on a larger row.
+ */
+void testBinomial() {
+    assert(BigInt::binomial(100, 50) == BigInt("100891344545564193334812497256"));
+    assert(BigInt::binomial(1000, 3) == BigInt(166167000));
+    assert(BigInt::binomial(7, 0) == BigInt(1));
+    assert(BigInt::binomial(7, 7) == BigInt(1));
+    assert(BigInt::binomial(5, 7) == BigInt(0));
+
+    for (uint64_t k = 1; k < 400; k += 37) {
+        assert(BigInt::binomial(400, k) == BigInt::binomial(399, k - 1) + BigInt::binomial(399, k));
+    }
+
+    assert(BigInt::multinomial({3, 4, 5}) == BigInt(27720));
+    assert(BigInt::multinomial({}) == BigInt(1));
+}
+
+/**
+ * @brief Tests the Fibonacci and Lucas numbers of the BigInt class.
+ *
+ * This function checks known values and Cassini's identity
+ * F(n + 1) * F(n - 1) - F(n)^2 = (-1)^n on larger indices.
+ */
+void testFibonacci() {
+    assert(BigInt::fibonacci(0) == BigInt(0));
+    assert(BigInt::fibonacci(1) == BigInt(1));
+    assert(BigInt::fibonacci(100) == BigInt("354224848179261915075"));
+    assert(BigInt::lucas(0) == BigInt(2));
+    assert(BigInt::lucas(1) == BigInt(1));
+    assert(BigInt::lucas(100) == BigInt("792070839848372253127"));
+
+    for (uint64_t n = 1000; n <= 1001; ++n) {
+        BigInt cassini = BigInt::fibonacci(n + 1) * BigInt::fibonacci(n - 1) - BigInt::fibonacci(n) * BigInt::fibonacci(n);
+        assert(cassini == BigInt(n % 2 == 0 ? 1 : -1));
+    }
+    assert(BigInt::fibonacci(2000) == BigInt::fibonacci(1000) * BigInt::lucas(1000));
+}
+
+/**
+ * @brief Tests the binary splitting series evaluation of the BigInt class.
+ *
+ * This function sums the series of e = 1 + 1/1! + 1/2! + ... with binarySplit, sequentially
+ * and in parallel, and checks the first 50 digits of pi from the Chudnovsky series.
+ */
+void testBinarySplit() {
+    auto one = [](uint64_t) { return BigInt(1); };
+    auto index = [](uint64_t n) { return BigInt(static_cast<int64_t>(n)); };
+    auto [p, q, t] = BigInt::binarySplit(1, 40, one, index, one);
+    BigInt e = (q + t) * BigInt("1000000000000000000000000000000") / q;
+    assert(p == BigInt(1));
+    assert(e == BigInt("2718281828459045235360287471352"));
+
+    auto [parallelP, parallelQ, parallelT] = BigInt::binarySplit(1, 40, one, index, one, 2);
+    assert(parallelP == p && parallelQ == q && parallelT == t);
+
+    assert(BigInt::piDigits(50) == BigInt("314159265358979323846264338327950288419716939937510"));
+    assert(BigInt::piDigits(0) == BigInt(3));
+}
+
+/**
+ * @brief Tests the Chinese remainder reconstruction and multi-modular reduction of the BigInt class.
+ *
+ * This function reduces a BigInt modulo word-size primes and small moduli, reconstructs it
+ * with crt, reuses a prebuilt tree for a negative value, and checks that non-coprime moduli throw.
+ */
+void testChineseRemainder() {
+    std::vector<uint64_t> moduli = {18446744073709551557ULL, 18446744073709551533ULL, 18446744073709551521ULL,
+                                    1000000007, 998244353, 3, 5, 7, 11};
+    BigInt x("123456789012345678901234567890123456789012345678901234567890");
+
+    std::vector<uint64_t> residues = BigInt::multiMod(x, moduli);
+    std::vector<uint64_t> expected = {14898563589646785423ULL, 11622346857381352925ULL, 578543226303837271ULL,
+                                      47102882, 127271830, 0, 0, 0, 3};
+    assert(residues == expected);
+    assert(BigInt::crt(residues, moduli) == x);
+
+    BigInt::ModuliTree tree = BigInt::buildModuliTree(moduli);
+    std::vector<uint64_t> negativeResidues = BigInt::multiMod(-x, tree);
+    assert(negativeResidues[0] == 3548180484062766134ULL);
+    assert(BigInt::crt(negativeResidues, tree) ==
+           BigInt("7237324022103741474209486752449142950711303449221676152773943282914463662506115"));
+
+    std::vector<uint64_t> single = {97};
+    std::vector<uint64_t> singleResidue = {42};
+    assert(BigInt::crt(singleResidue, single) == BigInt(42));
+
+    try {
+        std::vector<uint64_t> shared = {6, 9};
+        BigInt invalid = BigInt::crt(std::vector<uint64_t>{1, 2}, shared);
+        assert(false);
+    } catch (const std::invalid_argument&) {
+    }
+}
+
+/**
+ * @brief Tests the power and random generation functions of the BigInt class.
+ *
+ * This function checks pow, that random values stay inside their range, that the same
+ * seed gives the same values, and that a non-positive bound throws.
+ */
+void testRandom() {
+    assert(BigInt::pow(BigInt(2), 100) == BigInt("1267650600228229401496703205376"));
+    assert(BigInt::pow(BigInt(-3), 3) == BigInt(-27));
+    assert(BigInt::pow(BigInt(0), 0) == BigInt(1));
+
+    std::mt19937_64 rng(2024);
+    BigInt bound("1000000000000000000000000000000000000001");
+    BigInt twoTo130 = BigInt::pow(BigInt(2), 130);
+    bool sawLarge = false;
+    for (int i = 0; i < 200; ++i) {
+        BigInt below = BigInt::randomBelow(bound, rng);
+        assert(below >= BigInt(0) && below < bound);
+        BigInt bits = BigInt::randomBits(130, rng);
+        assert(bits >= BigInt(0) && bits < twoTo130);
+        sawLarge = sawLarge || bits >= BigInt::pow(BigInt(2), 129);
+    }
+    assert(sawLarge);
+    assert(BigInt::randomBits(0, rng) == BigInt(0));
+
+    std::unordered_set<BigInt> drawn;
+    for (int i = 0; i < 1200; ++i) {
+        BigInt below = BigInt::randomBelow(BigInt(12), rng);
+        assert(below >= BigInt(0) && below < BigInt(12));
+        drawn.insert(below);
+    }
+    assert(drawn.size() == 12);
+
+    std::mt19937_64 first(7);
+    std::mt19937_64 second(7);
+    assert(BigInt::randomBits(500, first) == BigInt::randomBits(500, second));
+
+    try {
+        BigInt invalid = BigInt::randomBelow(BigInt(0), rng);
+        assert(false);
+    } catch (const std::invalid_argument&) {
+    }
+}
+
+/**
+ * @brief Tests the floating-point conversions and logarithms of the BigInt class.
+ *
+ * This function checks round-to-nearest-even at a halfway case, overflow to infinity,
+ * truncation in the floating-point constructor, and the logarithm approximations.
+ */
+void testDoubleConversion() {
+    assert(BigInt(0).toDouble() == 0.0);
+    assert(BigInt(-12345).toDouble() == -12345.0);
+    assert(BigInt("9007199254740993").toDouble() == 9007199254740992.0);
+    assert(BigInt("9007199254740995").toDouble() == 9007199254740996.0);
+    assert(BigInt("12345678901234567890123").toDouble() == 1.2345678901234568e22);
+
+    BigInt largest = BigInt::pow(BigInt(2), 1024) - BigInt::pow(BigInt(2), 970);
+    assert((largest - BigInt(1)).toDouble() == std::numeric_limits<double>::max());
+    assert(largest.toDouble() == std::numeric_limits<double>::infinity());
+    assert((-BigInt::pow(BigInt(10), 400)).toDouble() == -std::numeric_limits<double>::infinity());
+
+    assert(BigInt(-2.9) == BigInt(-2));
+    assert(BigInt(0.5) == BigInt(0));
+    assert(BigInt(1e30) == BigInt("1000000000000000019884624838656"));
+    assert(BigInt(123456.75L) == BigInt(123456));
+    long double wide = std::ldexp(static_cast<long double>(1), std::numeric_limits<long double>::digits) - 1;
+    assert(BigInt(wide) == BigInt::pow(BigInt(2), static_cast<uint64_t>(std::numeric_limits<long double>::digits)) - BigInt(1));
+    assert(BigInt(-std::ldexp(wide, 100)) == -(BigInt(wide) * BigInt::pow(BigInt(2), 100)));
+    try {
+        BigInt invalid(std::numeric_limits<double>::quiet_NaN());
+        assert(false);
+    } catch (const std::invalid_argument&) {
+    }
+
+    assert(std::abs(BigInt::pow(BigInt(2), 1000).log2() - 1000.0) < 1e-9);
+    assert(std::abs(BigInt("-1000000000000000000000000000000").log10() - 30.0) < 1e-12);
+    assert(BigInt(0).log2() == -std::numeric_limits<double>::infinity());
+}
+
+/**
+ * @brief Tests that the schoolbook and Karatsuba multiplications agree.
+ *
+ * This function multiplies balanced and unbalanced random operands with several
+ * thresholds, including one that disables Karatsuba, and restores the threshold.
+ */
+void testKaratsuba() {
+    size_t saved = BigInt::karatsubaThreshold();
+    std::mt19937_64 rng(62);
+    for (int i = 0; i < 10; ++i) {
+        BigInt a = BigInt::randomBits(200 + 300 * static_cast<uint64_t>(i), rng) - BigInt::randomBits(300, rng);
+        BigInt b = BigInt::randomBits(i % 2 == 0 ? 3000 : 700, rng);
+
+        BigInt::karatsubaThreshold() = SIZE_MAX;
+        BigInt schoolbook = a * b;
+        for (size_t threshold : std::vector<size_t>{2, 5, 17, 64}) {
+            BigInt::karatsubaThreshold() = threshold;
+            assert(a * b == schoolbook);
+        }
+        assert(schoolbook / b == a);
+    }
+    BigInt::karatsubaThreshold() = saved;
+}
+
+/**
+ * @brief Tests the operation counters.
+ *
+ * With BIGINT_INSTRUMENT the calls and tiers are counted per thread, otherwise every counter stays zero.
+ */
+void testInstrumentation() {
+    size_t saved = BigInt::karatsubaThreshold();
+    BigInt::karatsubaThreshold() = 16;
+    BigInt a(std::string(100, '9'));
+    BigInt b(std::string(60, '7'));
+    BigInt::resetStatistics();
+    BigInt product = a * b;
+    BigInt quotient = product / a;
+    BigInt::karatsubaThreshold() = saved;
+    BigIntStats stats = BigInt::statistics();
+
+#ifdef BIGINT_INSTRUMENT
+    assert(stats[BigIntOperation::Multiply].calls == 1);
+    assert(stats[BigIntOperation::Multiply].digitOperations == 160);
+    assert(stats[BigIntOperation::MultiplyKaratsuba].calls > 0);
+    assert(stats[BigIntOperation::MultiplySchoolbook].calls > 0);
+    assert(stats[BigIntOperation::Divide].calls == 1);
+    assert(stats[BigIntOperation::Parse].calls == 0);
+    assert(std::async(std::launch::async, [] { return BigInt::statistics()[BigIntOperation::Multiply].calls; }).get() == 0);
+    assert(stats.toJson().find("{\"operation\": \"multiply.karatsuba\", \"calls\": ") != std::string::npos);
+    std::ostringstream table;
+    table << stats;
+    assert(table.str().find("divide") != std::string::npos);
+    assert(table.str().find("parse") == std::string::npos);
+#else
+    for (const BigIntCounter& counter : stats.counters) {
+        assert(counter.calls == 0 && counter.nanoseconds == 0);
+    }
+#endif
+    assert(quotient == b);
+}
+
+/**
+ * @brief Tests the allocation counters.
+ *
+ * With BIGINT_TRACK_ALLOCATIONS a copy allocates once, a move does not allocate, and the peak
+ * of a multiplication covers its product; otherwise the allocation counters stay zero.
+ */
+void testAllocationTracking() {
+    BigInt a(std::string(300, '8'));
+    BigInt b(std::string(200, '6'));
+    BigInt::resetStatistics();
+    BigInt copy = a;
+    BigInt moved = std::move(copy);
+    BigIntStats stats = BigInt::statistics();
+
+#ifdef BIGINT_TRACK_ALLOCATIONS
+    assert(stats[BigIntOperation::Other].allocations == 1);
+    assert(stats[BigIntOperation::Other].allocatedBytes == 300 * sizeof(int64_t));
+    assert(stats.currentBytes == static_cast<int64_t>(300 * sizeof(int64_t)));
+
+    BigInt::resetStatistics();
+    {
+        BigInt product = a * b;
+        assert(product / b == a);
+    }
+    stats = BigInt::statistics();
+    assert(stats.currentBytes == 0);
+    assert(stats[BigIntOperation::Multiply].peakBytes >= 500 * sizeof(int64_t));
+    assert(stats[BigIntOperation::MultiplyKaratsuba].allocations == stats[BigIntOperation::MultiplyKaratsuba].deallocations);
+    assert(stats.peakBytes >= static_cast<int64_t>(stats[BigIntOperation::Multiply].peakBytes));
+#else
+    assert(stats.peakBytes == 0);
+    for (const BigIntCounter& counter : stats.counters) {
+        assert(counter.allocations == 0 && counter.allocatedBytes == 0);
+    }
+#endif
+    assert(moved == a);
+}
+
+/**
+ * @brief Tests the trace events.
+ *
+ * With BIGINT_TRACE the recursion of a multiplication is written as Chrome trace events,
+ * including the events of a thread that has ended, and the number of kept events stays
+ * bounded; otherwise the trace is empty.
+ */
+void testTracing() {
+    size_t saved = BigInt::karatsubaThreshold();
+    BigInt::karatsubaThreshold() = 16;
+    BigInt::clearTrace();
+    BigInt product = BigInt(std::string(100, '9')) * BigInt(std::string(80, '3'));
+    std::async(std::launch::async, [] { return BigInt::factorial(300); }).get();
+    BigInt::karatsubaThreshold() = saved;
+    std::ostringstream trace;
+    BigInt::writeTrace(trace);
+
+#ifdef BIGINT_TRACE
+    assert(trace.str().starts_with("{\"traceEvents\": [\n"));
+    assert(trace.str().find("{\"name\": \"multiply.karatsuba\", \"ph\": \"X\", \"pid\": 1, \"tid\": ") != std::string::npos);
+    assert(trace.str().find("\"name\": \"product_tree\"") != std::string::npos);
+
+    trace.str("");
+    BigInt::clearTrace();
+    std::async(std::launch::async, [] {
+        for (size_t i = 0; i < 2 * BIGINT_TRACE_CAPACITY; ++i) {
+            assert(BigInt(7) * BigInt(6) == BigInt(42));
+        }
+    }).get();
+    for (size_t i = 0; i < 2 * BIGINT_TRACE_CAPACITY; ++i) {
+        assert(BigInt(7) * BigInt(6) == BigInt(42));
+    }
+    BigInt::writeTrace(trace);
+    std::string text = trace.str();
+    size_t events = 0;
+    for (size_t at = text.find("\"ph\""); at != std::string::npos; at = text.find("\"ph\"", at + 1)) {
+        ++events;
+    }
+    assert(events >= BIGINT_TRACE_CAPACITY && events <= 2 * BIGINT_TRACE_CAPACITY);
+
+    trace.str("");
+    BigInt::clearTrace();
+    BigInt::writeTrace(trace);
+#endif
+    assert(trace.str() == "{\"traceEvents\": [\n]}\n");
+    assert(product / BigInt(std::string(80, '3')) == BigInt(std::string(100, '9')));
+}
+
+/**
+ * @brief Tests the three-way comparison of the BigInt class.
+ *
+ * This function verifies the ordering by sign, by length, and by the
+ * first differing digit, including digits behind long equal prefixes,
+ * and the relational operators derived from <=>.
+ */
+void testThreeWayComparison() {
+    BigInt zero(0);
+    BigInt one(1);
+    BigInt minusOne(-1);
+    assert((zero <=> zero) == std::strong_ordering::equal);
+    assert((minusOne <=> zero) == std::strong_ordering::less);
+    assert((one <=> minusOne) == std::strong_ordering::greater);
+    assert((BigInt(100) <=> BigInt(99)) == std::strong_ordering::greater);
+    assert((BigInt(-100) <=> BigInt(-99)) == std::strong_ordering::less);
+
+    std::string prefix(1000, '8');
+    for (size_t position : std::vector<size_t>{0, 1, 31, 32, 33, 63, 64, 500, 999}) {
+        std::string low = prefix;
+        std::string high = prefix;
+        high[position] = '9';
+        BigInt a(low);
+        BigInt b(high);
+        assert((a <=> b) == std::strong_ordering::less);
+        assert((b <=> a) == std::strong_ordering::greater);
+        assert((-a <=> -b) == std::strong_ordering::greater);
+        assert(a < b && b > a && a <= b && b >= a && a != b);
+        assert(!(b < a) && !(a > b) && !(b <= a) && !(a >= b));
+        assert((a <=> BigInt(low)) == std::strong_ordering::equal);
+        assert(a <= BigInt(low) && a >= BigInt(low) && a == BigInt(low));
+    }
+
+    std::vector<BigInt> values = {BigInt(5), BigInt(-12), BigInt(0), BigInt("123456789012345678901234567890"),
+                                  BigInt(-3), BigInt("-123456789012345678901234567890"), BigInt(12)};
+    std::sort(values.begin(), values.end());
+    for (size_t i = 1; i < values.size(); ++i) {
+        assert(values[i - 1] < values[i]);
+    }
+}
+
+/**
+ * @brief Tests the hash of the BigInt class.
+ *
+ * This function verifies that equal values hash equally, that the sign
+ * and the length change the hash, that nearby values spread over the
+ * buckets, and that BigInt keys an std::unordered_map.
+ */
+void testHash() {
+    std::hash<BigInt> hasher;
+    assert(hasher(BigInt("000123456789")) == hasher(BigInt(123456789)));
+    assert(hasher(BigInt("-0")) == hasher(BigInt(0)));
+    assert(hasher(BigInt(42)) != hasher(BigInt(-42)));
+    assert(hasher(BigInt(7)) != hasher(BigInt(70)));
+    assert(BigInt("98765432109876543210").hash() == hasher(BigInt("98765432109876543210")));
+
+    std::unordered_set<size_t> hashes;
+    std::vector<size_t> buckets(256, 0);
+    for (int64_t i = 0; i < 20000; ++i) {
+        size_t h = hasher(BigInt(i));
+        hashes.insert(h);
+        ++buckets[h % buckets.size()];
+    }
+    assert(hashes.size() == 20000);
+    for (size_t count : buckets) {
+        assert(count > 20 && count < 140);
+    }
+
+    std::unordered_map<BigInt, int> squares;
+    for (int i = -50; i <= 50; ++i) {
+        squares[BigInt(i) * BigInt(i) * BigInt("1000000000000000000000")] = i;
+    }
+    assert(squares.size() == 51);
+    assert(squares.at(BigInt("49000000000000000000000")) == -7 || squares.at(BigInt("49000000000000000000000")) == 7);
+    assert(squares.count(BigInt(2)) == 0);
+}
+
+/**
+ * @brief Tests the radix sort of the BigInt class.
+ *
+ * This function verifies that BigInt::sort agrees with std::sort on
+ * values of both signs, many lengths, long shared prefixes and
+ * duplicates, with one thread and with several.
+ */
+void testSort() {
+    std::vector<BigInt> empty;
+    BigInt::sort(empty);
+    std::vector<BigInt> single = {BigInt(-7)};
+    BigInt::sort(single);
+    assert(single[0] == BigInt(-7));
+
+    std::mt19937_64 rng(73);
+    std::string prefix(50, '4');
+    std::vector<BigInt> values;
+    for (int i = 0; i < 3000; ++i) {
+        BigInt value;
+        switch (rng() % 4) {
+            case 0:
+                value = BigInt::randomBits(rng() % 200, rng);
+                break;
+            case 1:
+                value = BigInt(prefix + std::to_string(rng() % 1000));
+                break;
+            case 2:
+                value = BigInt(static_cast<int64_t>(rng() % 100));
+                break;
+            default:
+                value = BigInt(prefix + prefix + std::to_string(rng() % 10));
+                break;
+        }
+        values.push_back(rng() % 2 == 0 ? -value : value);
+    }
+    std::vector<BigInt> expected = values;
+    std::sort(expected.begin(), expected.end());
+    for (size_t threads : std::vector<size_t>{1, 3, 8}) {
+        std::vector<BigInt> sorted = values;
+        BigInt::sort(sorted, threads);
+        assert(sorted == expected);
+    }
+}
+
+/**
+ * @brief Tests the BigIntArray container.
+ *
+ * This function verifies that the array keeps the values it is given,
+ * that its views and appends, including from itself, are correct, that
+ * empty views are stored as zero, and that its elementwise operations
+ * agree with those of BigInt.
+ */
+void testBigIntArray() {
+    std::vector<BigInt> left = {BigInt(0), BigInt(-7), BigInt("123456789012345678901234567890"), BigInt(99),
+                                BigInt("-98765432109876543210"), BigInt(5)};
+    std::vector<BigInt> right = {BigInt(-3), BigInt(7), BigInt("-123456789012345678901234567890"), BigInt(1),
+                                 BigInt("98765432109876543211"), BigInt(0)};
+    BigIntArray a(left);
+    BigIntArray b(right);
+    assert(a.size() == 6 && !a.empty());
+    assert(a.toVector() == left);
+    assert(BigInt(a[2]) == left[2]);
+    assert(a[1].isNegative && a[1].digits.size() == 1 && a[1].digits[0] == 7);
+    assert(BigInt(left[4].view()) == left[4]);
+
+    BigIntArray sum = a + b;
+    BigIntArray difference = a - b;
+    BigIntArray product = a * b;
+    for (size_t i = 0; i < left.size(); ++i) {
+        assert(BigInt(sum[i]) == left[i] + right[i]);
+        assert(BigInt(difference[i]) == left[i] - right[i]);
+        assert(BigInt(product[i]) == left[i] * right[i]);
+    }
+    assert(!sum[1].isNegative && !sum[2].isNegative && !product[5].isNegative);
+
+    a.push_back(a[2]);
+    a.append(a);
+    assert(a.size() == 14);
+    assert(BigInt(a[6]) == left[2] && BigInt(a[13]) == left[2] && BigInt(a[8]) == left[1]);
+    assert(a.digitCount() == 2 * (55 + 30));
+
+    BigIntArray zeros;
+    zeros.push_back(BigIntView{});
+    zeros.push_back(BigIntView{});
+    assert(zeros.digitCount() == 2 && zeros.toVector() == std::vector<BigInt>(2, BigInt(0)));
+    assert(BigInt((zeros * zeros)[0]) == BigInt(0) && BigInt((zeros - zeros)[1]) == BigInt(0));
+
+    bool thrown = false;
+    try {
+        static_cast<void>(a + b);
+    } catch (const std::invalid_argument&) {
+        thrown = true;
+    }
+    assert(thrown);
+    a.clear();
+    assert(a.empty() && a.digitCount() == 0 && a == BigIntArray());
+}
+
+/**
+ * @brief Tests the operations on BigIntView.
+ *
+ * This function verifies that views of digits held in a plain buffer
+ * and in a BigIntArray add, subtract, multiply, compare, print and hash
+ * the same as the BigInts they stand for, also mixed with BigInts, that
+ * an empty view and a negative zero view act as zero, that high zero
+ * digits of a padded buffer are ignored, and that a
+ * temporary BigInt does not convert to a view.
+ */
+void testBigIntView() {
+    std::vector<int64_t> buffer = {5, 4, 3, 2, 1, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 9};
+    BigIntView small{std::span<const int64_t>(buffer.data(), 5), false};
+    BigIntView large{std::span<const int64_t>(buffer), true};
+    BigInt smallValue(12345);
+    BigInt largeValue("-900000000000000012345");
+
+    assert(small + small == BigInt(24690));
+    assert(small - large == smallValue - largeValue);
+    assert(large - small == largeValue - smallValue);
+    assert(small * large == smallValue * largeValue);
+    BigInt difference = small - small;
+    assert(difference == BigInt(0) && !difference.view().isNegative);
+    assert(smallValue + large == smallValue + largeValue);
+    assert(large * smallValue == largeValue * smallValue);
+
+    assert(small == smallValue && smallValue == small && large != small);
+    assert(large < small && small > large && large <= largeValue && largeValue >= large);
+    BigInt next(12346);
+    assert((small <=> next) == std::strong_ordering::less);
+    static_assert(std::is_convertible_v<const BigInt&, BigIntView>);
+    static_assert(!std::is_convertible_v<BigInt&&, BigIntView>);
+
+    BigIntView empty;
+    int64_t zeroDigit = 0;
+    BigIntView negativeZero{std::span<const int64_t>(&zeroDigit, 1), true};
+    assert(empty + small == smallValue && empty - small == -smallValue && small - empty == smallValue);
+    BigInt zero(0);
+    BigInt product = empty * large;
+    assert(product == zero && !product.view().isNegative);
+    assert(empty == zero && negativeZero == empty && (empty <=> small) == std::strong_ordering::less);
+    assert(std::hash<BigIntView>()(empty) == BigInt(0).hash() && std::hash<BigIntView>()(negativeZero) == BigInt(0).hash());
+    assert(BigInt(empty) == BigInt(0));
+
+    std::vector<int64_t> padded = {5, 0, 0, 0};
+    std::vector<int64_t> zeros = {0, 0};
+    BigIntView five{std::span<const int64_t>(padded), false};
+    BigIntView paddedZero{std::span<const int64_t>(zeros), true};
+    BigInt fiveValue(5);
+    BigInt hundred(100);
+    assert(five == fiveValue && five < hundred && (five <=> fiveValue) == std::strong_ordering::equal);
+    assert(std::hash<BigIntView>()(five) == fiveValue.hash() && BigInt(five) == fiveValue);
+    assert(five * five == BigInt(25) && five - five == zero && paddedZero == zero);
+
+    std::ostringstream oss;
+    oss << large << " " << small << " " << empty << " " << negativeZero << " " << five << " " << paddedZero;
+    assert(oss.str() == "-900000000000000012345 12345 0 0 5 0");
+    assert(std::hash<BigIntView>()(large) == std::hash<BigInt>()(largeValue));
+    assert(std::hash<BigIntView>()(small) == smallValue.hash());
+
+    std::vector<BigInt> values = {BigInt(-50), BigInt("123456789123456789123456789"), BigInt(7)};
+    BigIntArray array(values);
+    assert(array[0] + array[1] == values[0] + values[1]);
+    assert(array[1] * array[2] == values[1] * values[2]);
+    assert(array[0] < array[2] && array[1] > array[2]);
+    oss.str("");
+    oss << array[0];
+    assert(oss.str() == "-50");
+}
+
 
 /**
  * @brief The main function for testing the BigInt class.
@@ -177,6 +883,66 @@ int main() {
 
     testLessThanOperator();
     std::cout << "Pass testLessThanOperator()\n";
+
+    testDivisionOperator();
+    std::cout << "Pass testDivisionOperator()\n";
+
+    testModularInverse();
+    std::cout << "Pass testModularInverse()\n";
+
+    testPrimality();
+    std::cout << "Pass testPrimality()\n";
+
+    testNextPrime();
+    std::cout << "Pass testNextPrime()\n";
+
+    testFactorial();
+    std::cout << "Pass testFactorial()\n";
+
+    testBinomial();
+    std::cout << "Pass testBinomial()\n";
+
+    testFibonacci();
+    std::cout << "Pass testFibonacci()\n";
+
+    testBinarySplit();
+    std::cout << "Pass testBinarySplit()\n";
+
+    testChineseRemainder();
+    std::cout << "Pass testChineseRemainder()\n";
+
+    testRandom();
+    std::cout << "Pass testRandom()\n";
+
+    testDoubleConversion();
+    std::cout << "Pass testDoubleConversion()\n";
+
+    testKaratsuba();
+    std::cout << "Pass testKaratsuba()\n";
+
+    testInstrumentation();
+    std::cout << "Pass testInstrumentation()\n";
+
+    testAllocationTracking();
+    std::cout << "Pass testAllocationTracking()\n";
+
+    testTracing();
+    std::cout << "Pass testTracing()\n";
+
+    testThreeWayComparison();
+    std::cout << "Pass testThreeWayComparison()\n";
+
+    testHash();
+    std::cout << "Pass testHash()\n";
+
+    testSort();
+    std::cout << "Pass testSort()\n";
+
+    testBigIntArray();
+    std::cout << "Pass testBigIntArray()\n";
+
+    testBigIntView();
+    std::cout << "Pass testBigIntView()\n";
     
     std::cout << "Pass all!!!\n";
     return 0;